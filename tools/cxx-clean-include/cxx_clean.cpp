@@ -39,14 +39,14 @@ void CxxCleanPreprocessor::FileChanged(SourceLocation loc, FileChangeReason reas
 
 	FileID curFileID = m_root->GetSrcMgr().getFileID(loc);
 
-	// Ҫע⣬еļǻᱻFileChanged©ģǰHeaderSearch::ShouldEnterIncludeFileΪÿζtrue
+	// ע⣺#includeFileChangedFileSkipped
 	m_root->AddFile(curFileID);
 }
 
-// ļ
-void CxxCleanPreprocessor::FileSkippedWithFileID(FileID fileID)
+// ļͷļ#pragma once
+void CxxCleanPreprocessor::FileSkipped(const FileEntryRef &skippedFile, const Token &filenameTok, SrcMgr::CharacteristicKind fileType)
 {
-	m_root->AddFile(fileID);
+	m_root->AddSkippedFile(filenameTok.getLocation(), &skippedFile.getFileEntry());
 }
 
 // ꣬#if defined DEBUG
@@ -74,16 +74,46 @@ void CxxCleanPreprocessor::MacroExpands(const Token &macroName, const MacroDefin
 void CxxCleanPreprocessor::Ifdef(SourceLocation loc, const Token &macroName, const MacroDefinition &definition)
 {
 	m_root->UseMacro(loc, definition, macroName);
+	m_root->AddCondition(loc, definition ? '1' : '0');
 }
 
 // #ifndef
 void CxxCleanPreprocessor::Ifndef(SourceLocation loc, const Token &macroName, const MacroDefinition &definition)
 {
 	m_root->UseMacro(loc, definition, macroName);
+	m_root->AddCondition(loc, definition ? '0' : '1');
+}
+
+// ֵָ'1'ʾ'0'ʾ'-'ʾδֵǰķ֧ѳʱ#elif
+static char GetConditionValue(PPCallbacks::ConditionValueKind conditionValue)
+{
+	switch (conditionValue)
+	{
+	case PPCallbacks::CVK_True:
+		return '1';
+	case PPCallbacks::CVK_False:
+		return '0';
+	default:
+		return '-';
+	}
+}
+
+// #if
+void CxxCleanPreprocessor::If(SourceLocation loc, SourceRange conditionRange, ConditionValueKind conditionValue)
+{
+	m_root->AddCondition(loc, GetConditionValue(conditionValue));
+}
+
+// #elif
+void CxxCleanPreprocessor::Elif(SourceLocation loc, SourceRange conditionRange, ConditionValueKind conditionValue, SourceLocation ifLoc)
+{
+	m_root->AddCondition(loc, GetConditionValue(conditionValue));
 }
 
 CxxCleanASTVisitor::CxxCleanASTVisitor(ParsingFile *rootFile)
 	: m_root(rootFile)
+	, m_isVisitInstantiations((Project::instance.m_traversePolicy & TraversePolicy_Instantiation) != 0)
+	, m_isVisitImplicit((Project::instance.m_traversePolicy & TraversePolicy_Implicit) != 0)
 {}
 
 // ʵ
@@ -104,170 +134,171 @@ bool CxxCleanASTVisitor::VisitStmt(Stmt *s)
 	}
 
 	// μhttp://clang.llvm.org/doxygen/classStmt.html
-	if (isa<CastExpr>(s))
+	// ע⣺ľͷɣÿֻһ֧CastExprǳ࣬ڶ࣬defaultͳһжϣ
+	switch (s->getStmtClass())
 	{
-		CastExpr *castExpr = cast<CastExpr>(s);
-		QualType castType = castExpr->getType();
-		CastKind castKind = castExpr->getCastKind();
-
-		switch (castKind)
+	case Stmt::CXXMemberCallExprClass:
 		{
-		// ໥תʱҪ⴦
-		case CK_UncheckedDerivedToBase :
-		case CK_BaseToDerived:
-		case CK_BaseToDerivedMemberPointer:
-		case CK_DerivedToBase:
-		case CK_DerivedToBaseMemberPointer:
-		case CK_Dynamic:
-			m_root->UseQualType(loc, castType);
-			m_root->UseQualType(loc, castExpr->getSubExpr()->getType());
-			break;
-
-		default:
-			m_root->UseVarType(loc, castType);
+			CXXMemberCallExpr *callExpr = cast<CXXMemberCallExpr>(s);
+			m_root->UseFuncDecl(loc, callExpr->getMethodDecl());
+			m_root->UseRecord(loc, callExpr->getRecordDecl());
 		}
-	}
-	else if (isa<CXXMemberCallExpr>(s))
-	{
-		CXXMemberCallExpr *callExpr = cast<CXXMemberCallExpr>(s);
-		m_root->UseFuncDecl(loc, callExpr->getMethodDecl());
-		m_root->UseRecord(loc, callExpr->getRecordDecl());
-	}
-	else if (isa<CallExpr>(s))
-	{
-		CallExpr *callExpr = cast<CallExpr>(s);
+		break;
 
-		Decl *calleeDecl = callExpr->getCalleeDecl();
-		if (NULL == calleeDecl)
+	// ãصĲõ
+	case Stmt::CallExprClass:
+	case Stmt::CXXOperatorCallExprClass:
+	case Stmt::CUDAKernelCallExprClass:
+	case Stmt::UserDefinedLiteralClass:
 		{
-			return true;
+			CallExpr *callExpr = cast<CallExpr>(s);
+
+			Decl *calleeDecl = callExpr->getCalleeDecl();
+			if (NULL == calleeDecl)
+			{
+				break;
+			}
+
+			if (isa<ValueDecl>(calleeDecl))
+			{
+				ValueDecl *valueDecl = cast<ValueDecl>(calleeDecl);
+				m_root->UseValueDecl(loc, valueDecl);
+			}
 		}
+		break;
 
-		if (isa<ValueDecl>(calleeDecl))
+	case Stmt::DeclRefExprClass:
 		{
-			ValueDecl *valueDecl = cast<ValueDecl>(calleeDecl);
+			DeclRefExpr *declRefExpr = cast<DeclRefExpr>(s);
+			ValueDecl *valueDecl = declRefExpr->getDecl();
+			const NestedNameSpecifier *specifier = declRefExpr->getQualifier();
+
+			m_root->SearchUsingAny(loc, specifier, valueDecl);
+			m_root->UseQualifier(loc, specifier);
 			m_root->UseValueDecl(loc, valueDecl);
 		}
-	}
-	else if (isa<DeclRefExpr>(s))
-	{
-		DeclRefExpr *declRefExpr = cast<DeclRefExpr>(s);
-		ValueDecl *valueDecl = declRefExpr->getDecl();
-		const NestedNameSpecifier *specifier = declRefExpr->getQualifier();
+		break;
 
-		m_root->SearchUsingAny(loc, specifier, valueDecl);
-		m_root->UseQualifier(loc, specifier);
-		m_root->UseValueDecl(loc, valueDecl);
-	}
 	// ǰΧȡԱ䣬磺this->print();
-	else if (isa<CXXDependentScopeMemberExpr>(s))
-	{
-		CXXDependentScopeMemberExpr *expr = cast<CXXDependentScopeMemberExpr>(s);
-		m_root->UseQualType(loc, expr->getBaseType());
-	}
+	case Stmt::CXXDependentScopeMemberExprClass:
+		m_root->UseQualType(loc, cast<CXXDependentScopeMemberExpr>(s)->getBaseType());
+		break;
+
 	// this
-	else if (isa<CXXThisExpr>(s))
-	{
-		CXXThisExpr *expr = cast<CXXThisExpr>(s);
-		m_root->UseQualType(loc, expr->getType());
-	}
+	case Stmt::CXXThisExprClass:
+		m_root->UseQualType(loc, cast<CXXThisExpr>(s)->getType());
+		break;
+
 	/// ṹunionĳԱ磺X->FX.F.
-	else if (isa<MemberExpr>(s))
-	{
-		MemberExpr *memberExpr = cast<MemberExpr>(s);
-		m_root->UseValueDecl(loc, memberExpr->getMemberDecl());
-	}
+	case Stmt::MemberExprClass:
+		m_root->UseValueDecl(loc, cast<MemberExpr>(s)->getMemberDecl());
+		break;
+
 	// delete
-	else if (isa<CXXDeleteExpr>(s))
-	{
-		CXXDeleteExpr *expr = cast<CXXDeleteExpr>(s);
-		m_root->UseQualType(loc, expr->getDestroyedType());
-	}
+	case Stmt::CXXDeleteExprClass:
+		m_root->UseQualType(loc, cast<CXXDeleteExpr>(s)->getDestroyedType());
+		break;
+
 	// ȡԪ䣬磺a[0]4[a]
-	else if (isa<ArraySubscriptExpr>(s))
-	{
-		ArraySubscriptExpr *expr = cast<ArraySubscriptExpr>(s);
-		m_root->UseQualType(loc, expr->getType());
-	}
+	case Stmt::ArraySubscriptExprClass:
+		m_root->UseQualType(loc, cast<ArraySubscriptExpr>(s)->getType());
+		break;
+
 	// typeid䣬磺typeid(int) or typeid(*obj)
-	else if (isa<CXXTypeidExpr>(s))
-	{
-		CXXTypeidExpr *expr = cast<CXXTypeidExpr>(s);
-		m_root->UseQualType(loc, expr->getType());
-	}
-	// ๹
-	else if (isa<CXXConstructExpr>(s))
-	{
-		CXXConstructExpr *cxxConstructExpr = cast<CXXConstructExpr>(s);
-		m_root->UseConstructor(loc, cxxConstructExpr->getConstructor());
-	}
+	case Stmt::CXXTypeidExprClass:
+		m_root->UseQualType(loc, cast<CXXTypeidExpr>(s)->getType());
+		break;
+
+	// ๹䣨ʱ죬磺A(1, 2)
+	case Stmt::CXXConstructExprClass:
+	case Stmt::CXXTemporaryObjectExprClass:
+		m_root->UseConstructor(loc, cast<CXXConstructExpr>(s)->getConstructor());
+		break;
+
 	// new
-	else if (isa<CXXNewExpr>(s))
-	{
-		CXXNewExpr *cxxNewExpr = cast<CXXNewExpr>(s);
+	case Stmt::CXXNewExprClass:
+		{
+			CXXNewExpr *cxxNewExpr = cast<CXXNewExpr>(s);
 
-		const FunctionDecl *operatorNew		= cxxNewExpr->getOperatorNew();
-		const FunctionDecl *operatorDelete	= cxxNewExpr->getOperatorDelete();
+			const FunctionDecl *operatorNew		= cxxNewExpr->getOperatorNew();
+			const FunctionDecl *operatorDelete	= cxxNewExpr->getOperatorDelete();
 
-		m_root->UseFuncDecl(loc, operatorNew);
-		m_root->UseFuncDecl(loc, operatorDelete);
-	}
-	// delete
-	else if (isa<CXXDeleteExpr>(s))
-	{
-		CXXDeleteExpr *cxxDeleteExpr	= cast<CXXDeleteExpr>(s);
-		const FunctionDecl *operatorDelete	= cxxDeleteExpr->getOperatorDelete();
+			m_root->UseFuncDecl(loc, operatorNew);
+			m_root->UseFuncDecl(loc, operatorDelete);
+		}
+		break;
 
-		m_root->UseFuncDecl(loc, operatorDelete);
-		m_root->UseQualType(loc, cxxDeleteExpr->getDestroyedType());
-	}
 	// sizeof(A)
-	else if (isa<UnaryExprOrTypeTraitExpr>(s))
-	{
-		UnaryExprOrTypeTraitExpr *unaryExprOrTypeTraitExpr = cast<UnaryExprOrTypeTraitExpr>(s);
-		m_root->UseVarType(loc, unaryExprOrTypeTraitExpr->getTypeOfArgument());
-	}
-	/*
-	// ע⣺һκҪԺ־
-
-	// DeclRefExprҪʵʱ֪ͣ磺T::
-	else if (isa<DependentScopeDeclRefExpr>(s)){}
-	// return䣬磺return 4;return;
-	else if (isa<ReturnStmt>(s)){}
-	// űʽ磺(1)(a + b)
-	else if (isa<ParenExpr>(s)){}
-	// ϱʽɲͬʽ϶
-	else if(isa<CompoundStmt>(s)){}
-	// Ԫʽ磺"x + y" or "x <= y"δأBinaryOperatorأͽCXXOperatorCallExpr
-	else if (isa<BinaryOperator>(s)){}
-	// һԪʽ磺+-++Լ--,߼ǣλȡ~ȡַ&ȡֵָָ*
-	else if (isa<UnaryOperator>(s)){}
-	// 
-	else if (isa<IntegerLiteral>(s)){}
-	// Ԫʽʽ磺 x ? y : z
-	else if (isa<ConditionalOperator>(s)){}
-	// for䣬磺for(;;){ int i = 0; }
-	else if (isa<ForStmt>(s)){}
-	else if (isa<UnaryExprOrTypeTraitExpr>(s) || isa<InitListExpr>(s) || isa<MaterializeTemporaryExpr>(s)){}
-	// δ֪͵Ĺ캯
-	else if (isa<CXXUnresolvedConstructExpr>(s)){}
-	// c++11Ĵչ䣬...ʡԺ
-	else if (isa<PackExpansionExpr>(s)){}
-	else if (isa<UnresolvedLookupExpr>(s) || isa<CXXBindTemporaryExpr>(s) || isa<ExprWithCleanups>(s)){}
-	else if (isa<ParenListExpr>(s)){}
-	else if (isa<DeclStmt>(s)){}
-	else if (isa<IfStmt>(s) || isa<SwitchStmt>(s) || isa<CXXTryStmt>(s) || isa<CXXCatchStmt>(s) || isa<CXXThrowExpr>(s)){}
-	else if (isa<StringLiteral>(s) || isa<CharacterLiteral>(s) || isa<CXXBoolLiteralExpr>(s) || isa<FloatingLiteral>(s)){}
-	else if (isa<NullStmt>(s)){}
-	else if (isa<CXXDefaultArgExpr>(s)){}
-	//	c++ĳԱ䣬ʿʽʽ
-	else if (isa<UnresolvedMemberExpr>(s)){}
-	else
-	{
+	case Stmt::UnaryExprOrTypeTraitExprClass:
+		m_root->UseVarType(loc, cast<UnaryExprOrTypeTraitExpr>(s)->getTypeOfArgument());
+		break;
+
+	default:
+		if (CastExpr *castExpr = dyn_cast<CastExpr>(s))
+		{
+			QualType castType = castExpr->getType();
+			CastKind castKind = castExpr->getCastKind();
+
+			switch (castKind)
+			{
+			// ໥תʱҪ⴦
+			case CK_UncheckedDerivedToBase :
+			case CK_BaseToDerived:
+			case CK_BaseToDerivedMemberPointer:
+			case CK_DerivedToBase:
+			case CK_DerivedToBaseMemberPointer:
+			case CK_Dynamic:
+				m_root->UseQualType(loc, castType);
+				m_root->UseQualType(loc, castExpr->getSubExpr()->getType());
+				break;
+
+			default:
+				m_root->UseVarType(loc, castType);
+			}
+		}
+
+		/*
+		// ע⣺һκҪԺ־٣Ŀǰ
+
+		// DeclRefExprҪʵʱ֪ͣ磺T::
+		DependentScopeDeclRefExpr
+		// return䣬磺return 4;return;
+		ReturnStmt
+		// űʽ磺(1)(a + b)
+		ParenExpr
+		// ϱʽɲͬʽ϶
+		CompoundStmt
+		// Ԫʽ磺"x + y" or "x <= y"δأBinaryOperatorأͽCXXOperatorCallExpr
+		BinaryOperator
+		// һԪʽ磺+-++Լ--,߼ǣλȡ~ȡַ&ȡֵָָ*
+		UnaryOperator
+		// 
+		IntegerLiteral
+		// Ԫʽʽ磺 x ? y : z
+		ConditionalOperator
+		// for䣬磺for(;;){ int i = 0; }
+		ForStmt
+		InitListExprMaterializeTemporaryExpr
+		// δ֪͵Ĺ캯
+		CXXUnresolvedConstructExpr
+		// c++11Ĵչ䣬...ʡԺ
+		PackExpansionExpr
+		UnresolvedLookupExprCXXBindTemporaryExprExprWithCleanups
+		ParenListExpr
+		DeclStmt
+		IfStmtSwitchStmtCXXTryStmtCXXCatchStmtCXXThrowExpr
+		StringLiteralCharacterLiteralCXXBoolLiteralExprFloatingLiteral
+		NullStmt
+		CXXDefaultArgExpr
+		//	c++ĳԱ䣬ʿʽʽ
+		UnresolvedMemberExpr
+
+		// ӡδֵ֧䣺
 		log() << "<pre>------------ havn't support stmt ------------:</pre>\n";
 		PrintStmt(s);
+		*/
+		break;
 	}
-	*/
 
 	return true;
 }
@@ -351,16 +382,9 @@ bool CxxCleanASTVisitor::VisitCXXRecordDecl(CXXRecordDecl *r)
 		m_root->UseQualType(loc, base.getType());
 	}
 
-	// Աע⣺staticԱstaticԱVisitVarDeclбʵ
-	for (CXXRecordDecl::field_iterator itr = r->field_begin(), end = r->field_end(); itr != end; ++itr)
-	{
-		FieldDecl *field = *itr;
-		m_root->UseValueDecl(loc, field);
-	}
-
 	m_root->UseQualifier(loc, r->getQualifier());
 
-	// ԱҪΪVisitFunctionDeclʳԱ
+	// ԱԱҪΪVisitFieldDeclVisitFunctionDeclʵstaticԱVisitVarDeclʣ
 	return true;
 }
 
@@ -491,34 +515,46 @@ bool CxxCleanASTVisitor::VisitCXXConstructorDecl(CXXConstructorDecl *constructor
 	return true;
 }
 
-// 
-bool CxxCleanASTVisitor::VisitCXXConstructExpr(CXXConstructExpr *expr)
+CxxCleanASTConsumer::CxxCleanASTConsumer(ParsingFile *rootFile)
+	: m_root(rootFile), m_visitor(rootFile), m_traverseSeconds(0)
+{}
+
+// ǣķ
+bool CxxCleanASTConsumer::HandleTopLevelDecl(DeclGroupRef declgroup)
 {
-	SourceLocation loc = expr->getBeginLoc();
-	if (m_root->IsInSystemHeader(loc))
+	// ʽÿһ鶥ʹ﷨ͬʱ
+	if (Project::instance.m_isStreaming)
 	{
-		return true;
+		double beg = timetool::get_seconds();
+
+		for (Decl *decl : declgroup)
+		{
+			StreamDecl(decl);
+		}
+
+		m_traverseSeconds += timetool::get_seconds() - beg;
 	}
 
-	m_root->UseConstructor(expr->getBeginLoc(), expr->getConstructor());
 	return true;
 }
 
-CxxCleanASTConsumer::CxxCleanASTConsumer(ParsingFile *rootFile)
-	: m_root(rootFile), m_visitor(rootFile)
-{}
-
-// ǣķ
-bool CxxCleanASTConsumer::HandleTopLevelDecl(DeclGroupRef declgroup)
+// ǣģʽ£Ƿúĺ壨עconstexprֵƵĺclang
+bool CxxCleanASTConsumer::shouldSkipFunctionBody(Decl *decl)
 {
-	return true;
+	// ģʵʱʵģ庯õļ
+	if ((Project::instance.m_traversePolicy & TraversePolicy_Instantiation) && decl->isTemplated())
+	{
+		return false;
+	}
+
+	return m_root->IsSkipFunctionBody(decl->getLocation());
 }
 
 // ÿԴļһΣ磬һhello.cpp#includeͷļҲֻһα
 void CxxCleanASTConsumer::HandleTranslationUnit(ASTContext& context)
 {
 	// ڵԣӡ﷨
-	if (Project::instance.m_logLvl >= LogLvl_Max)
+	if (IsLogLvl<LogLvl_Max>())
 	{
 		std::string strLog;
 		raw_string_ostream logStream(strLog);
@@ -535,8 +571,120 @@ void CxxCleanASTConsumer::HandleTranslationUnit(ASTContext& context)
 	// 1. ǰcppļʼ
 	m_root->Begin();
 
-	// 2. ﷨
-	m_visitor.TraverseDecl(context.getTranslationUnitDecl());
+	// 2. ﷨ϵͳļеΪϵͳͷļеĽڵһɲ
+	double beg = timetool::get_seconds();
+
+	if (Project::instance.m_isStreaming)
+	{
+		// ʽʱHandleTopLevelDeclб
+		for (Decl *decl : m_deferredDecls)
+		{
+			m_visitor.TraverseDecl(decl);
+		}
+
+		m_deferredDecls.clear();
+	}
+	else
+	{
+		TraverseNonSystemDecls(context.getTranslationUnitDecl());
+	}
+
+	// 3. ͳƱʱڱȽϸ
+	m_traverseSeconds += timetool::get_seconds() - beg;
+
+	ProjectHistory::instance.g_traverseSeconds	+= m_traverseSeconds;
+	ProjectHistory::instance.g_useEdgeNum		+= m_root->GetUseEdgeCount();
+
+	LogInfoByLvl(LogLvl_2, "traverse policy = " << Project::instance.GetTraversePolicyName() << ", traverse time = " << m_traverseSeconds << "s, use edge count = " << m_root->GetUseEdgeCount());
+}
+
+// ĳλڷϵͳļϵͳͷļеϵͳͷļеnamespaceextern "C"
+void CxxCleanASTConsumer::TraverseNonSystemDecls(DeclContext *context)
+{
+	for (Decl *decl : context->decls())
+	{
+		// еȡʼλáеȡλã߶ϵͳͷļʱ
+		if (!m_root->IsInSystemHeader(decl->getBeginLoc()) || !m_root->IsInSystemHeader(decl->getLocation()))
+		{
+			m_visitor.TraverseDecl(decl);
+			continue;
+		}
+
+		// ϵͳͷļnamespaceextern "C"п#include˷ϵͳļ磺namespace std { #include "user.h" }
+		if (isa<NamespaceDecl>(decl) || isa<LinkageSpecDecl>(decl))
+		{
+			TraverseNonSystemDecls(cast<DeclContext>(decl));
+		}
+	}
+}
+
+// ʽսĶ뵥Ԫϲܱȴ
+void CxxCleanASTConsumer::StreamDecl(Decl *decl)
+{
+	bool isInSystem = m_root->IsInSystemHeader(decl->getBeginLoc()) && m_root->IsInSystemHeader(decl->getLocation());
+	bool isContext	= (isa<NamespaceDecl>(decl) || isa<LinkageSpecDecl>(decl));
+
+	// namespaceextern "C"ܴܺеģҪƳٱ
+	if (isContext)
+	{
+		// namespace
+		NamespaceDecl *ns = dyn_cast<NamespaceDecl>(decl);
+		if (ns && !isInSystem)
+		{
+			m_visitor.WalkUpFromNamespaceDecl(ns);
+		}
+
+		for (Decl *kid : cast<DeclContext>(decl)->decls())
+		{
+			StreamDecl(kid);
+		}
+
+		return;
+	}
+
+	// TraverseNonSystemDeclsһ£ϵͳͷļе
+	if (isInSystem)
+	{
+		return;
+	}
+
+	if (IsNeedCompleteTU(decl))
+	{
+		m_deferredDecls.push_back(decl);
+		return;
+	}
+
+	m_visitor.TraverseDecl(decl);
+}
+
+// Ƿ뵥ԪϺܱ
+//	1. ģ弰ģĳԱʵܷڱ뵥Ԫĩβ
+//	2. ӳٽĺ壨翪-fdelayed-template-parsing
+//	3. 
+bool CxxCleanASTConsumer::IsNeedCompleteTU(const Decl *decl)
+{
+	if (decl->isTemplated())
+	{
+		return true;
+	}
+
+	if (const FunctionDecl *f = dyn_cast<FunctionDecl>(decl))
+	{
+		return f->isLateTemplateParsed();
+	}
+
+	if (const CXXRecordDecl *record = dyn_cast<CXXRecordDecl>(decl))
+	{
+		for (const Decl *member : record->decls())
+		{
+			if (IsNeedCompleteTU(member))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
 }
 
 CxxcleanDiagnosticConsumer::CxxcleanDiagnosticConsumer(DiagnosticOptions *diags)
@@ -623,6 +771,10 @@ bool CxxCleanAction::BeginSourceFileAction(CompilerInstance &compiler)
 {
 	string filename = "";
 	++ProjectHistory::instance.g_fileNum;
+
+	// ClangToolڷÿc++ļǰлļıĿ¼
+	pathtool::on_current_path_changed();
+
 	Log("cleaning file: " << ProjectHistory::instance.g_fileNum << "/" << Project::instance.m_cpps.size() << ". " << filename << " ...");
 	return true;
 }
@@ -630,16 +782,35 @@ bool CxxCleanAction::BeginSourceFileAction(CompilerInstance &compiler)
 // ļ
 void CxxCleanAction::EndSourceFileAction()
 {
+	// ȡݺ﷨òˣͷŵԽڴֵ
+	m_root->TakeSnapshot();
+	ReleaseAST();
+
 	m_root->End();
 	delete m_root;
 	m_root = nullptr;
 }
 
+// ͷ﷨ԤԴԱΪдԴʱҪõ
+void CxxCleanAction::ReleaseAST()
+{
+	CompilerInstance &compiler = getCompilerInstance();
+
+	// עͷ˳SemaASTConsumerASTContextASTContextԤеıʶ
+	compiler.setSema(nullptr);
+	compiler.setASTContext(nullptr);
+	compiler.setASTConsumer(nullptr);
+	compiler.setPreprocessor(nullptr);
+}
+
 // ﷨
 std::unique_ptr<ASTConsumer> CxxCleanAction::CreateASTConsumer(CompilerInstance &compiler, StringRef file)
 {
 	m_root = new ParsingFile(compiler);
 
+	// ģʽ﷨ڽÿǰѯshouldSkipFunctionBody
+	compiler.getFrontendOpts().SkipFunctionBodies = Project::instance.m_isSkipFunctionBodies;
+
 	compiler.getPreprocessor().addPPCallbacks(std::make_unique<CxxCleanPreprocessor>(m_root));
 	return std::make_unique<CxxCleanASTConsumer>(m_root);
 }
@@ -650,8 +821,17 @@ static cl::opt<string>	g_vsOption		("vs", cl::desc("clean visual studio project(
 static cl::opt<bool>	g_noOverWrite	("no", cl::desc("means no overwrite, all c++ file will not be changed"), cl::cat(g_optionCategory));
 static cl::opt<bool>	g_onlyCleanCpp	("onlycpp", cl::desc("only allow clean cpp file(cpp, cc, cxx), don't clean the header file(h, hxx, hh)"), cl::cat(g_optionCategory));
 static cl::opt<bool>	g_printVsConfig	("print-vs", cl::desc("print vs configuration"), cl::cat(g_optionCategory));
+static cl::opt<TraversePolicy> g_traversePolicy("traverse", cl::desc("ast traverse policy, default is written"),
+        cl::values(
+            clEnumValN(TraversePolicy_Written,			"written",			"only traverse the code as written (fastest)"),
+            clEnumValN(TraversePolicy_Instantiation,	"instantiation",	"also traverse template instantiations"),
+            clEnumValN(TraversePolicy_Implicit,			"implicit",			"also traverse implicit code, such as implicit constructors"),
+            clEnumValN(TraversePolicy_Full,				"full",				"traverse template instantiations and implicit code")
+        ), cl::init(TraversePolicy_Written), cl::cat(g_optionCategory));
+static cl::opt<bool>	g_streaming		("stream", cl::desc("traverse each top-level declaration as soon as it is parsed, templates are still traversed after the whole file is parsed"), cl::cat(g_optionCategory));
+static cl::opt<bool>	g_skipBodies	("skip-bodies", cl::desc("skip function bodies in system headers, and in library headers which only depend on their own includes in the files analyzed before. a file is analyzed again if such a header includes different files or takes different #if branches than before"), cl::cat(g_optionCategory));
 static cl::opt<int>		g_logLevel		("v", cl::desc("log level(verbose level), level can be 0 ~ 4, default is 1, higher level will print more detail"), cl::cat(g_optionCategory));
-static cl::list<string>	g_skips			("skip", cl::desc("skip files"), cl::cat(g_optionCategory));
+static cl::list<string>	g_skips			("skip", cl::desc("skip files whose path contains the given text(case insensitive, may be given many times), these files and their included files will not be changed, format:-skip boost/ -skip third_party"), cl::cat(g_optionCategory));
 static cl::opt<string>	g_cleanOption	("clean",
         cl::desc("format:\n"
                  "    1. clean directory: -clean ../hello/\n"
@@ -686,6 +866,7 @@ bool CxxCleanOptionsParser::ParseOptions(int &argc, const char **argv)
 
 	// ºļ-skipѡֵ
 	Add(Project::instance.m_skips, g_skips);
+	Project::instance.GenerateSkipMatcher();
 
 	HtmlLog::instance->Open();
 
@@ -881,6 +1062,9 @@ bool CxxCleanOptionsParser::ParseCleanOption()
 	Project &project			= Project::instance;
 
 	project.m_isOverWrite		= !g_noOverWrite;
+	project.m_isStreaming		= g_streaming;
+	project.m_isSkipFunctionBodies	= g_skipBodies;
+	project.m_traversePolicy	= g_traversePolicy;
 	project.m_workingDir		= pathtool::get_current_path();
 
 	std::string vsOption		= g_vsOption;
@@ -952,6 +1136,7 @@ bool CxxCleanOptionsParser::ParseCleanOption()
 			}
 
 			Add(project.m_canCleanFiles, all);
+			project.m_canCleanDirs.insert(strtool::tolower(directory.c_str()));
 
 			// -vsѡΪ
 			if (vsOption.empty())
@@ -999,6 +1184,7 @@ bool CxxCleanOptionsParser::ParseCleanOption()
 				strtool::ws2s(cn_log_name_cpp_file1) + get_file_html(filePath.c_str()) + strtool::ws2s(cn_log_name_cpp_file2));
 		}
 
+		project.GenerateCanCleanTrie();
 		project.Fix();
 	}
 
@@ -1006,9 +1192,12 @@ bool CxxCleanOptionsParser::ParseCleanOption()
 	if (g_onlyCleanCpp)
 	{
 		project.m_canCleanFiles.clear();
+		project.m_canCleanDirs.clear();
 		Add(project.m_canCleanFiles, project.m_cpps);
 	}
 
+	project.GenerateCanCleanTrie();
+
 	if (vsOption == clean_option && !vsOption.empty())
 	{
 		Log("error! need select c++ file of visual studio project <" << vsOption << ">!");
@@ -1036,6 +1225,13 @@ bool CxxCleanOptionsParser::ParseLogOption()
 		return false;
 	}
 
+	// ߼ĵԴڱڱ޳
+	if (logLvl > CXXCLEAN_MAX_LOG_LVL)
+	{
+		Log("warning: verbose level " << logLvl << " is not supported by this build, use level " << (int)CXXCLEAN_MAX_LOG_LVL << " instead.");
+		Project::instance.m_logLvl = (LogLvl)CXXCLEAN_MAX_LOG_LVL;
+	}
+
 	return true;
 }
 
@@ -39,8 +39,8 @@ public:
 	// ļл
 	void FileChanged(SourceLocation loc, FileChangeReason reason, SrcMgr::CharacteristicKind FileType, FileID prevFileID = FileID()) override;
 
-	// ļ
-	void FileSkippedWithFileID(FileID);
+	// ļͷļ#pragma once
+	void FileSkipped(const FileEntryRef &skippedFile, const Token &filenameTok, SrcMgr::CharacteristicKind fileType) override;
 
 	// ꣬#if defined DEBUG
 	void Defined(const Token &macroName, const MacroDefinition &definition, SourceRange range) override;
@@ -60,6 +60,12 @@ public:
 	// #ifndef
 	void Ifndef(SourceLocation loc, const Token &macroName, const MacroDefinition &definition) override;
 
+	// #if
+	void If(SourceLocation loc, SourceRange conditionRange, ConditionValueKind conditionValue) override;
+
+	// #elif
+	void Elif(SourceLocation loc, SourceRange conditionRange, ConditionValueKind conditionValue, SourceLocation ifLoc) override;
+
 private:
 	// ǰڽcppļϢ
 	ParsingFile *m_root;
@@ -71,6 +77,12 @@ class CxxCleanASTVisitor : public RecursiveASTVisitor<CxxCleanASTVisitor>
 public:
 	explicit CxxCleanASTVisitor(ParsingFile *rootFile);
 
+	// ԣǷģʵĴ
+	bool shouldVisitTemplateInstantiations() const { return m_isVisitInstantiations; }
+
+	// ԣǷʽɵĴ
+	bool shouldVisitImplicitCode() const { return m_isVisitImplicit; }
+
 	// ʵ
 	bool VisitStmt(Stmt *s);
 
@@ -104,12 +116,15 @@ public:
 	// 
 	bool VisitCXXConstructorDecl(CXXConstructorDecl *decl);
 
-	// 
-	bool VisitCXXConstructExpr(CXXConstructExpr *expr);
-
 private:
 	// ǰڽcppļϢ
 	ParsingFile*	m_root;
+
+	// ǷģʵĴ
+	bool			m_isVisitInstantiations;
+
+	// ǷʽɵĴ
+	bool			m_isVisitImplicit;
 };
 
 // ʵASTConsumerӿڶȡclangɵast﷨
@@ -124,12 +139,30 @@ public:
 	// ÿԴļһΣ磬һhello.cpp#includeͷļҲֻһα
 	void HandleTranslationUnit(ASTContext& context) override;
 
+	// ĳλڷϵͳļϵͳͷļеϵͳͷļеnamespaceextern "C"
+	void TraverseNonSystemDecls(DeclContext *context);
+
+	// ʽսĶ뵥Ԫϲܱȴ
+	void StreamDecl(Decl *decl);
+
+	// Ƿ뵥ԪϺܱ
+	static bool IsNeedCompleteTU(const Decl *decl);
+
+	// ǣģʽ£Ƿúĺ
+	bool shouldSkipFunctionBody(Decl *decl) override;
+
 public:
 	// ǰڽcppļϢ
 	ParsingFile*		m_root;
 
 	// ﷨
 	CxxCleanASTVisitor	m_visitor;
+
+	// ʽʱƳٵHandleTranslationUnitвűȺУ
+	std::vector<Decl*>	m_deferredDecls;
+
+	// ﷨ۼƺʱ룩
+	double				m_traverseSeconds;
 };
 
 // `TextDiagnosticPrinter`ԽϢӡڿ̨ϣΪ˵Է㽫Ϊ
@@ -168,6 +201,9 @@ public:
 	// ﷨
 	std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &compiler, StringRef file) override;
 
+	// ͷ﷨ԤԴԱΪдԴʱҪõ
+	void ReleaseAST();
+
 private:
 	// ǰڽcppļϢ
 	ParsingFile	*m_root;
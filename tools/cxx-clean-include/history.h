@@ -91,6 +91,18 @@ struct ReplaceLine
 	ReplaceTo					replaceTo;			// 滻#includeб
 };
 
+// ģʽѽⲿͷļڱжʱ״̬
+struct ResolvedHeader
+{
+	bool operator==(const ResolvedHeader &other) const
+	{
+		return kids == other.kids && conds == other.conds;
+	}
+
+	std::set<string>			kids;				// ļĺļ
+	string						conds;				// ļڸָ#if#elif#ifdef#ifndefֵȺ
+};
+
 // ÿļıʷ
 struct CompileErrorHistory
 {
@@ -187,6 +199,8 @@ class ProjectHistory
 {
 	ProjectHistory()
 		: g_fileNum(0)
+		, g_traverseSeconds(0)
+		, g_useEdgeNum(0)
 	{}
 
 public:
@@ -205,6 +219,42 @@ public:
 		return m_files.find(file) != m_files.end();
 	}
 
+	// ¼ĳⲿͷļڱηǷֻĺļstateΪηиļĺļ
+	// һĳ뵥Ԫļļ֮ǰͬͲΪѽ
+	void OnHeaderResolved(const string &file, bool isResolved, const ResolvedHeader &state)
+	{
+		if (isResolved && m_unresolvedHeaders.find(file) == m_unresolvedHeaders.end())
+		{
+			auto itr = m_resolvedHeaders.find(file);
+			if (itr == m_resolvedHeaders.end())
+			{
+				m_resolvedHeaders.insert(std::make_pair(file, state));
+				return;
+			}
+
+			if (itr->second == state)
+			{
+				return;
+			}
+		}
+
+		m_resolvedHeaders.erase(file);
+		m_unresolvedHeaders.insert(file);
+	}
+
+	// ͷļǷѽڼ仹֪ĺļֻļжϣ
+	bool IsHeaderResolved(const string &file) const
+	{
+		return m_resolvedHeaders.find(file) != m_resolvedHeaders.end();
+	}
+
+	// ͷļǷѽҺļжѽʱͬ
+	bool IsHeaderResolved(const string &file, const ResolvedHeader &state) const
+	{
+		auto itr = m_resolvedHeaders.find(file);
+		return itr != m_resolvedHeaders.end() && itr->second == state;
+	}
+
 	// 
 	void Fix();
 
@@ -221,6 +271,21 @@ public:
 	// ļעѱļظ
 	std::set<string>	m_cleanedFiles;
 
+	// ѽⲿͷļֻļ亯岻Ӱļķ֮ı뵥Ԫ亯壺[ļ] -> [жʱļ״̬]
+	std::map<string, ResolvedHeader>	m_resolvedHeaders;
+
+	// ļļǰһµⲿͷļ
+	std::set<string>	m_unresolvedHeaders;
+
+	// ģʽ״̬Ѹıͷļĺ壬ɿ·c++ļ
+	std::vector<string>	m_retryFiles;
+
 	// ڴӡǰڴڼļ
 	int					g_fileNum;
+
+	// ڴӡ﷨ۼƺʱ룩ڱȽϸ
+	double				g_traverseSeconds;
+
+	// ڴӡļڱȽϸ
+	int					g_useEdgeNum;
 };
\ No newline at end of file
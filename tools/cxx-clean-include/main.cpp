@@ -31,10 +31,10 @@ bool Init(CxxCleanOptionsParser &optionParser, int argc, const char **argv)
 	return ok;
 }
 
-// ʼ
-void Run(const CxxCleanOptionsParser &optionParser)
+// ָc++ļз
+void RunTool(const CxxCleanOptionsParser &optionParser, const std::vector<std::string> &cpps)
 {
-	ClangTool tool(optionParser.getCompilations(), Project::instance.m_cpps);
+	ClangTool tool(optionParser.getCompilations(), cpps);
 	tool.clearArgumentsAdjusters();
 	tool.appendArgumentsAdjuster(getClangSyntaxOnlyAdjuster());
 
@@ -53,6 +53,28 @@ void Run(const CxxCleanOptionsParser &optionParser)
 	// ÿļ﷨
 	tool.run(newFrontendActionFactory<CxxCleanAction>().get());
 
+	// ClangToolϺָԭĵǰ·
+	pathtool::on_current_path_changed();
+}
+
+// ʼ
+void Run(const CxxCleanOptionsParser &optionParser)
+{
+	RunTool(optionParser, Project::instance.m_cpps);
+
+	// ģʽ·ɿļͷļѲΪѽ亯彫ÿһͷļȡԱض
+	while (!ProjectHistory::instance.m_retryFiles.empty())
+	{
+		std::vector<std::string> retryFiles;
+		retryFiles.swap(ProjectHistory::instance.m_retryFiles);
+
+		Log("-- analyze again: file count = " << retryFiles.size() << " --");
+		RunTool(optionParser, retryFiles);
+	}
+
+	// ӡ﷨ܺʱڱȽϸԣӦѡԣ
+	Log("-- traverse policy = " << Project::instance.GetTraversePolicyName() << ", traverse time = " << ProjectHistory::instance.g_traverseSeconds << "s, use edge count = " << ProjectHistory::instance.g_useEdgeNum << " --");
+
 	ProjectHistory::instance.Print();
 	HtmlLog::instance->Close();
 }
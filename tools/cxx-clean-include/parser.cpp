@@ -7,6 +7,7 @@
 #include "parser.h"
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 
 #include <clang/AST/DeclTemplate.h>
 #include <clang/Lex/HeaderSearch.h>
@@ -28,8 +29,8 @@
 ParsingFile* ParsingFile::g_nowFile = nullptr;
 
 // setȥset
-template <typename T>
-inline void Del(std::set<T> &a, const std::set<T> &b)
+template <typename T, typename Cmp, typename Alloc, typename Cmp2, typename Alloc2>
+inline void Del(std::set<T, Cmp, Alloc> &a, const std::set<T, Cmp2, Alloc2> &b)
 {
 	for (const T &t : b)
 	{
@@ -38,8 +39,8 @@ inline void Del(std::set<T> &a, const std::set<T> &b)
 }
 
 // setȥmap
-template <typename Key, typename Val>
-inline void Del(std::set<Key> &a, const std::map<Key, Val> &b)
+template <typename Key, typename Cmp, typename Alloc, typename Val, typename MapCmp, typename MapAlloc>
+inline void Del(std::set<Key, Cmp, Alloc> &a, const std::map<Key, Val, MapCmp, MapAlloc> &b)
 {
 	for (const auto &itr : b)
 	{
@@ -48,8 +49,8 @@ inline void Del(std::set<Key> &a, const std::map<Key, Val> &b)
 }
 
 // mapȥset
-template <typename Key, typename Val>
-inline void Del(std::map<Key, Val> &a, const std::set<Key> &b)
+template <typename Key, typename Val, typename MapCmp, typename MapAlloc, typename Cmp, typename Alloc>
+inline void Del(std::map<Key, Val, MapCmp, MapAlloc> &a, const std::set<Key, Cmp, Alloc> &b)
 {
 	for (const Key &t : b)
 	{
@@ -58,8 +59,8 @@ inline void Del(std::map<Key, Val> &a, const std::set<Key> &b)
 }
 
 // setsetзĳԱ
-template <typename Key, typename Op>
-inline void AddIf(std::set<Key> &a, const std::set<Key> &b, const Op& op)
+template <typename Key, typename Cmp, typename Alloc, typename Cmp2, typename Alloc2, typename Op>
+inline void AddIf(std::set<Key, Cmp, Alloc> &a, const std::set<Key, Cmp2, Alloc2> &b, const Op& op)
 {
 	for (const Key &key : b)
 	{
@@ -105,12 +106,42 @@ inline bool HasInMap(const Container &container, const Key1 &a, const Key2 &b)
 	return Has(itr->second, b);
 }
 
+// ʹü¼[ļ, class]ȽϴС
+inline bool IsLessByFileRecord(const UseRecordItem &a, const UseRecordItem &b)
+{
+	return a.file < b.file || (a.file == b.file && a.record < b.record);
+}
+
+// ʹü¼[ļ, class]жǷͬ
+inline bool IsSameFileRecord(const UseRecordItem &a, const UseRecordItem &b)
+{
+	return a.file == b.file && a.record == b.record;
+}
+
+// ʹü¼[ļ, λ, class]ȽϴС
+inline bool IsLessByFileLocRecord(const UseRecordItem &a, const UseRecordItem &b)
+{
+	if (a.file != b.file)
+	{
+		return a.file < b.file;
+	}
+
+	if (a.loc != b.loc)
+	{
+		return a.loc < b.loc;
+	}
+
+	return a.record < b.record;
+}
+
 // ȡļļab1b2b1b2b3 ~ b100ab1 ~ b100
-template <typename T, typename AddTodoFunc>
-void GetChain(std::set<T> &chain, T top, const AddTodoFunc& expand)
+template <typename Set, typename AddTodoFunc>
+void GetChain(Set &chain, typename Set::value_type top, const AddTodoFunc& expand)
 {
-	std::set<T> todo;
-	std::set<T> &done = chain;
+	typedef typename Set::value_type T;
+
+	Set todo;
+	Set &done = chain;
 
 	todo.insert(top);
 
@@ -122,7 +153,7 @@ void GetChain(std::set<T> &chain, T top, const AddTodoFunc& expand)
 		{
 			done.insert(cur);
 
-			std::set<T> more;
+			Set more;
 			expand(done, more, cur);
 
 			todo.erase(todo.begin());
@@ -136,15 +167,32 @@ void GetChain(std::set<T> &chain, T top, const AddTodoFunc& expand)
 }
 
 ParsingFile::ParsingFile(clang::CompilerInstance &compiler)
+	: m_minInclude(m_arena.Get())
+	, m_fowardClass(m_arena.Get())
+	, m_minKids(m_arena.Get())
+	, m_userFiles(m_arena.Get())
+	, m_outFileAncestor(m_arena.Get())
+	, m_userUses(m_arena.Get())
+	, m_defaultIncludes(m_arena.Get())
+	, m_skips(m_arena.Get())
+	, m_uses(m_arena.Get())
+	, m_includes(m_arena.Get())
+	, m_files(m_arena.Get())
+	, m_parents(m_arena.Get())
+	, m_sameFiles(m_arena.Get())
+	, m_fileNames(m_arena.Get())
+	, m_lowerFileNames(m_arena.Get())
 {
 	m_compiler	= &compiler;
 	m_srcMgr	= &compiler.getSourceManager();
 	m_printIdx	= 0;
 	g_nowFile	= this;
 	m_root		= m_srcMgr->getMainFileID();
+	m_isBegun	= false;
 
 	m_rewriter.setSourceMgr(*m_srcMgr, compiler.getLangOpts());
 	m_headerSearchPaths = TakeHeaderSearchPaths(m_compiler->getPreprocessor().getHeaderSearchInfo());
+	GenerateHeaderSearchTrie();
 }
 
 ParsingFile::~ParsingFile()
@@ -160,26 +208,53 @@ void ParsingFile::AddFile(FileID file)
 		return;
 	}
 
-	m_files.insert(file);
+	bool isNewFile = m_files.insert(file).second;
 
-	// ¼ļ
-	const std::string fileName = GetAbsoluteFileName(file);
-	if (!fileName.empty())
+	// ¼ļͬһļΰʱֻ״γʱ·Сд·ֱ֮
+	const FileEntry *entry = m_srcMgr->getFileEntryForID(file);
+	auto entryItr = (entry ? m_fileEntries.find(entry) : m_fileEntries.end());
+	if (entryItr != m_fileEntries.end())
 	{
-		const std::string lowerFileName = strtool::tolower(fileName);
+		FileID first = entryItr->second;
 
-		m_fileNames.insert(std::make_pair(file, fileName));
-		m_lowerFileNames.insert(std::make_pair(file, lowerFileName));
-		m_sameFiles[lowerFileName].insert(file);
+		auto nameItr = m_lowerFileNames.find(first);
+		if (nameItr != m_lowerFileNames.end())
+		{
+			m_fileNames.insert(std::make_pair(file, std::string(GetFileNameInCache(first))));
+			m_lowerFileNames.insert(std::make_pair(file, nameItr->second));
+			m_sameFiles[nameItr->second].insert(file);
 
-		if (!Has(m_fileNameToFileIDs, lowerFileName))
+			if (Has(m_skips, first))
+			{
+				m_skips.insert(file);
+			}
+		}
+	}
+	else
+	{
+		if (entry)
 		{
-			m_fileNameToFileIDs.insert(std::make_pair(lowerFileName, file));
+			m_fileEntries.insert(std::make_pair(entry, file));
 		}
 
-		if (Project::instance.IsSkip(lowerFileName.c_str()))
+		const std::string fileName = GetAbsoluteFileName(file);
+		if (!fileName.empty())
 		{
-			m_skips.insert(file);
+			const std::string lowerFileName = strtool::tolower(fileName);
+
+			m_fileNames.insert(std::make_pair(file, fileName));
+			m_lowerFileNames.insert(std::make_pair(file, lowerFileName));
+			m_sameFiles[lowerFileName].insert(file);
+
+			if (!Has(m_fileNameToFileIDs, lowerFileName))
+			{
+				m_fileNameToFileIDs.insert(std::make_pair(lowerFileName, file));
+			}
+
+			if (Project::instance.IsSkip(lowerFileName.c_str()))
+			{
+				m_skips.insert(file);
+			}
 		}
 	}
 
@@ -194,14 +269,102 @@ void ParsingFile::AddFile(FileID file)
 
 		if (file != parent)
 		{
-			const std::string parentName = strtool::tolower(GetAbsoluteFileName(parent));
-
 			m_parents[file] = parent;
-			m_includes[parentName].insert(file);
+			AddInclude(parent, file);
+		}
+	}
+
+	// ļ򣨼Ⱥ˳ν룬ԸļĴһڱļ
+	if (isNewFile)
+	{
+		IncludeOrder order;
+		order.seq		= (int)m_includeOrders.size();
+		order.lastKid	= order.seq;
+		order.line		= (IsForceInclude(file) ? 0 : GetLineNo(m_srcMgr->getIncludeLoc(file)));
+
+		FileID parent = GetParent(file);
+		if (const IncludeOrder *parentOrder = GetIncludeOrder(parent))
+		{
+			order.depth = parentOrder->depth + 1;
+		}
+
+		m_includeOrders[file] = order;
+
+		// ˢ¸ļĺ
+		for (; parent.isValid(); parent = GetParent(parent))
+		{
+			auto itr = m_includeOrders.find(parent);
+			if (itr != m_includeOrders.end())
+			{
+				itr->second.lastKid = order.seq;
+			}
 		}
 	}
 }
 
+// ĳļ#includeͷļ#pragma onceʱµļIDԼΪļ״αʱļID
+// ע⣺ļIDİλ״ΰļ#includeܼm_includesʱĵļУֻڼļ
+void ParsingFile::AddSkippedFile(SourceLocation loc, const FileEntry *entry)
+{
+	// #include MACROʱļλںչ
+	SourceLocation at = GetExpasionLoc(loc);
+	FileID parent = GetFileID(at);
+
+	auto itr = m_fileEntries.find(entry);
+	if (parent.isInvalid() || itr == m_fileEntries.end())
+	{
+		return;
+	}
+
+	FileID kid = itr->second;
+	if (kid == parent)
+	{
+		return;
+	}
+
+	SkippedInclude skipped;
+	skipped.loc		= at;
+	skipped.parent	= parent;
+	skipped.kid		= kid;
+
+	m_skippedIncludes.push_back(skipped);
+
+	// ʽʱ﷨ͬʱУʱҪõļ
+	if (Project::instance.m_isStreaming)
+	{
+		AddKidByName(GetLowerFileNameInCache(parent), GetLowerFileNameInCache(kid));
+	}
+}
+
+// ģʽһֵָĺԻᾭԤηͬһͷļĽֱӱȽϣ
+void ParsingFile::AddCondition(SourceLocation loc, char value)
+{
+	if (!Project::instance.m_isSkipFunctionBodies || IsInSystemHeader(loc))
+	{
+		return;
+	}
+
+	const char *fileName = GetLowerFileNameInCache(GetFileID(loc));
+	if (*fileName == '\0')
+	{
+		return;
+	}
+
+	m_condsByName[fileName] += value;
+}
+
+// ¼һ#includeϵļڴ֮ǰӣļֱӴӻȡ
+void ParsingFile::AddInclude(FileID parent, FileID kid)
+{
+	const std::string parentName = GetLowerFileNameInCache(parent);
+
+	// ʽʱ﷨ͬʱУʱҪõļ
+	if (m_includes[parentName].insert(kid).second && Project::instance.m_isStreaming)
+	{
+		AddKidByName(parentName, GetLowerFileNameInCache(kid));
+	}
+}
+
 // ȡͷļ·
 vector<ParsingFile::HeaderSearchDir> ParsingFile::TakeHeaderSearchPaths(const clang::HeaderSearch &headerSearch) const
 {
@@ -258,22 +421,125 @@ string ParsingFile::GetQuotedIncludeStr(const char *absoluteFilePath) const
 {
 	string path = pathtool::simplify_path(absoluteFilePath);
 
-	for (const HeaderSearchDir &itr : m_headerSearchPaths)
+	size_t prefixLen = 0;
+
+	const HeaderSearchDir *dir = GetLongestHeaderSearchDir(path, prefixLen);
+	if (nullptr == dir)
+	{
+		return "";
+	}
+
+	const char *relativePath = path.c_str() + prefixLen;
+
+	if (dir->m_dirType == SrcMgr::C_System)
 	{
-		if (strtool::try_strip_left(path, itr.m_dir))
+		return "<" + string(relativePath) + ">";
+	}
+	else
+	{
+		return "\"" + string(relativePath) + "\"";
+	}
+}
+
+// ͷļ·б·ǰ׺
+void ParsingFile::GenerateHeaderSearchTrie()
+{
+	m_headerSearchTrie.assign(1, HeaderSearchNode());
+
+	// ·ѰɳУظ·ȳֵΪ׼
+	for (int i = 0, n = (int)m_headerSearchPaths.size(); i < n; ++i)
+	{
+		const string &dir = m_headerSearchPaths[i].m_dir;
+
+		int node = 0;
+
+		for (size_t beg = 0; beg < dir.size();)
 		{
-			if (itr.m_dirType == SrcMgr::C_System)
+			size_t end = dir.find('/', beg);
+			if (end == string::npos)
 			{
-				return "<" + path + ">";
+				end = dir.size();
 			}
-			else
+
+			const string part = dir.substr(beg, end - beg);
+
+			int kid = -1;
+			for (const auto &itr : m_headerSearchTrie[node].kids)
 			{
-				return "\"" + path + "\"";
+				if (itr.first == part)
+				{
+					kid = itr.second;
+					break;
+				}
+			}
+
+			if (kid < 0)
+			{
+				kid = (int)m_headerSearchTrie.size();
+				m_headerSearchTrie.push_back(HeaderSearchNode());
+				m_headerSearchTrie[node].kids.push_back(std::make_pair(part, kid));
 			}
+
+			node = kid;
+			beg = end + 1;
+		}
+
+		if (m_headerSearchTrie[node].dir < 0)
+		{
+			m_headerSearchTrie[node].dir = i;
 		}
 	}
+}
 
-	return "";
+// ҳ·ƥͷļ·prefixLenƥ䲿ֵĳȣأnullptrʾδҵ
+const ParsingFile::HeaderSearchDir* ParsingFile::GetLongestHeaderSearchDir(const std::string &path, size_t &prefixLen) const
+{
+	if (m_headerSearchTrie.empty())
+	{
+		return nullptr;
+	}
+
+	const HeaderSearchDir *best = nullptr;
+
+	int node = 0;
+
+	// ֻ/β·βſļУ²Ҳ·
+	for (size_t beg = 0; beg < path.size();)
+	{
+		size_t end = path.find('/', beg);
+		if (end == string::npos)
+		{
+			break;
+		}
+
+		size_t len = end - beg;
+
+		int kid = -1;
+		for (const auto &itr : m_headerSearchTrie[node].kids)
+		{
+			if (itr.first.size() == len && 0 == path.compare(beg, len, itr.first))
+			{
+				kid = itr.second;
+				break;
+			}
+		}
+
+		if (kid < 0)
+		{
+			break;
+		}
+
+		node = kid;
+		beg = end + 1;
+
+		if (m_headerSearchTrie[node].dir >= 0)
+		{
+			best		= &m_headerSearchPaths[m_headerSearchTrie[node].dir];
+			prefixLen	= beg;
+		}
+	}
+
+	return best;
 }
 
 // 2ļǷļһ
@@ -287,6 +553,9 @@ void ParsingFile::Analyze()
 {
 	LogInfoByLvl(LogLvl_3, "------ Analyze ------");
 
+	// 0. ڼ׷ӵʹü¼
+	SortUseRecords();
+
 	// δǱߵҪ˼·
 
 	// 1. ¼ÿûļʹõûļ
@@ -304,6 +573,203 @@ void ParsingFile::Analyze()
 	// ȡ
 	TakeHistorys(m_historys);
 	MergeTo(ProjectHistory::instance.m_files);
+
+	if (Project::instance.m_isSkipFunctionBodies)
+	{
+		TakeResolvedHeaders();
+	}
+}
+
+// ģʽ¼±ηֻļⲿͷļ
+void ParsingFile::TakeResolvedHeaders() const
+{
+	// ⲿͷļĺļУGenerateUserUseлᱻȫԣ亯岻Ӱļķ
+	std::map<std::string, bool> headers;
+	for (FileID file : m_files)
+	{
+		if (file != m_root && !IsSystemHeader(file) && !CanClean(file))
+		{
+			headers.insert(std::make_pair(GetLowerFileNameInCache(file), true));
+		}
+	}
+
+	auto IsInside = [&](FileID beUse, FileID by)
+	{
+		return IsSameName(beUse, by) || IsAncestorByName(beUse, by);
+	};
+
+	for (const auto &itr : m_uses)
+	{
+		FileID by = itr.first;
+
+		auto headerItr = headers.find(GetLowerFileNameInCache(by));
+		if (headerItr == headers.end())
+		{
+			continue;
+		}
+
+		for (FileID beUse : itr.second)
+		{
+			if (!IsInside(beUse, by))
+			{
+				headerItr->second = false;
+				break;
+			}
+		}
+	}
+
+	// ָ롢ʹõ࣬岻ĺļУǰҲܱŲļ
+	for (const UseRecordItem &use : m_fileUseRecordPointers)
+	{
+		auto headerItr = headers.find(GetLowerFileNameInCache(use.file));
+		if (headerItr == headers.end())
+		{
+			continue;
+		}
+
+		const RecordFact &record = m_records[use.record];
+		if (std::none_of(record.files.begin(), record.files.end(), [&](FileID recordAtFile) { return IsInside(recordAtFile, use.file); }))
+		{
+			headerItr->second = false;
+		}
+	}
+
+	for (const auto &itr : headers)
+	{
+		ProjectHistory::instance.OnHeaderResolved(itr.first, itr.second, GetHeaderState(itr.first));
+	}
+}
+
+// ģʽͷļļǷжѽʱͬأtrueʾηȻ׼ȷ
+// 궨塢ͷļ·ͬͬһͷļڲͬı뵥Ԫпܰͬļ#ifdef벻ͬķ֧ʱ亯õļ
+bool ParsingFile::CheckSkippedBodies() const
+{
+	bool isExact = true;
+
+	for (const std::string &header : m_skippedBodyHeaders)
+	{
+		const ResolvedHeader state = GetHeaderState(header);
+
+		if (!ProjectHistory::instance.IsHeaderResolved(header, state))
+		{
+			LogInfo("header is no longer resolved, file will be analyzed again: " << header);
+			ProjectHistory::instance.OnHeaderResolved(header, false, state);
+			isExact = false;
+		}
+	}
+
+	return isExact;
+}
+
+// ģʽȡͷļڱηе״̬ļ
+ResolvedHeader ParsingFile::GetHeaderState(const std::string &header) const
+{
+	ResolvedHeader state;
+
+	auto kidItr = m_kidsByName.find(header);
+	if (kidItr != m_kidsByName.end())
+	{
+		state.kids = kidItr->second;
+	}
+
+	auto condItr = m_condsByName.find(header);
+	if (condItr != m_condsByName.end())
+	{
+		state.conds = condItr->second;
+	}
+
+	return state;
+}
+
+// ģʽλõĺǷڵòӰ쵱ǰ뵥Ԫķ
+bool ParsingFile::IsSkipFunctionBody(SourceLocation loc)
+{
+	// ϵͳͷļеᱻ亯ǿ
+	if (IsInSystemHeader(loc))
+	{
+		return true;
+	}
+
+	// ɱļ
+	const char *fileName = GetLowerFileNameInCache(GetFileID(loc));
+	if (*fileName == '\0' || CanCleanByName(fileName))
+	{
+		return false;
+	}
+
+	if (!ProjectHistory::instance.IsHeaderResolved(fileName))
+	{
+		return false;
+	}
+
+	// ϡļȷٺ˶
+	m_skippedBodyHeaders.insert(fileName);
+	return true;
+}
+
+// ڼ׷ӵʹü¼ȥ
+void ParsingFile::SortUseRecords()
+{
+	auto SortUnique = [](UseRecordVec &records)
+	{
+		std::sort(records.begin(), records.end(), IsLessByFileRecord);
+		records.erase(std::unique(records.begin(), records.end(), IsSameFileRecord), records.end());
+	};
+
+	SortUnique(m_fileUseRecordPointers);
+	SortUnique(m_fileUseRecords);
+
+	std::sort(m_locUseRecordPointers.begin(), m_locUseRecordPointers.end(), IsLessByFileLocRecord);
+	m_locUseRecordPointers.erase(std::unique(m_locUseRecordPointers.begin(), m_locUseRecordPointers.end(), [](const UseRecordItem &a, const UseRecordItem &b)
+	{
+		return a.file == b.file && a.loc == b.loc && a.record == b.record;
+	}), m_locUseRecordPointers.end());
+}
+
+// ʽʱÿһ#includeϵ͸ļĺļBeginһͬ
+void ParsingFile::AddKidByName(const std::string &parent, const std::string &kid)
+{
+	m_includersByName[kid].insert(parent);
+
+	// ĺ = kid + kidеĺstd::mapԪصַ䣬追
+	auto kidItr = m_kidsByName.find(kid);
+	const FileNameSet *kidKids = (kidItr != m_kidsByName.end() ? &kidItr->second : nullptr);
+
+	// parentʼŰϣÿȶЩº
+	// ע⣺ǴݱհĳkidȾkidȫ
+	std::vector<std::string> todo(1, parent);
+	std::set<std::string> done;
+
+	while (!todo.empty())
+	{
+		std::string top = todo.back();
+		todo.pop_back();
+
+		if (top == kid || !done.insert(top).second)
+		{
+			continue;
+		}
+
+		FileNameSet &kids = m_kidsByName[top];
+		if (Has(kids, kid))
+		{
+			continue;
+		}
+
+		kids.insert(kid);
+		if (kidKids)
+		{
+			Add(kids, *kidKids);
+		}
+
+		kids.erase(top);
+
+		auto includerItr = m_includersByName.find(top);
+		if (includerItr != m_includersByName.end())
+		{
+			todo.insert(todo.end(), includerItr->second.begin(), includerItr->second.end());
+		}
+	}
 }
 
 // ǰcppļʼ
@@ -314,9 +780,26 @@ void ParsingFile::Begin()
 	// 1. ÿļĺļҪõ
 	m_files.erase(FileID());
 
+	// #includeҲϵ[ļ] -> [includeļ]
+	std::map<std::string, FileNameSet> skippedKids;
+	for (const SkippedInclude &skipped : m_skippedIncludes)
+	{
+		skippedKids[GetLowerFileNameInCache(skipped.parent)].insert(GetLowerFileNameInCache(skipped.kid));
+	}
+
+	FileNameSet tops;
 	for (const auto &itr : m_includes)
 	{
-		const std::string &top = itr.first;
+		tops.insert(itr.first);
+	}
+
+	for (const auto &itr : skippedKids)
+	{
+		tops.insert(itr.first);
+	}
+
+	for (const std::string &top : tops)
+	{
 		FileNameSet &kids = m_kidsByName[top];
 		kids.clear();
 		GetChain(kids, top, [&](const FileNameSet &done, FileNameSet &todo, const std::string &cur)
@@ -330,6 +813,12 @@ void ParsingFile::Begin()
 					todo.insert(GetLowerFileNameInCache(beInclude));
 				}
 			}
+
+			auto skippedItr = skippedKids.find(cur);
+			if (skippedItr != skippedKids.end())
+			{
+				Add(todo, skippedItr->second);
+			}
 		});
 
 		kids.erase(top);
@@ -345,15 +834,98 @@ void ParsingFile::Begin()
 	// 3. ¼ǿưļбΪǿưļļӦĶ
 	LogInfoByLvl(LogLvl_3, "<<generate default includes>>");
 	GenerateDefaultIncludes();
+	GenerateFileFlags();
 
 	// 4. ¼ÿⲿļⲿ
 	LogInfoByLvl(LogLvl_3, "<<generate out files>>");
 	GenerateOutFileAncestor();
+
+	m_isBegun = true;
+
+	// 5. ʽʱBegin֮ǰƳٴָ롢
+	for (const PendingForwardUse &use : m_pendingForwardUses)
+	{
+		UseForwardType(use.loc, use.record, use.specifier);
+	}
+
+	m_pendingForwardUses.clear();
+	m_includersByName.clear();
+}
+
+// ﷨ȡݣ˺ٷ﷨﷨ͷ
+void ParsingFile::TakeSnapshot()
+{
+	// 1. classstructunionֻ豣ȫڵļ
+	m_records.resize(m_recordDecls.size());
+
+	for (size_t i = 0, n = m_recordDecls.size(); i < n; ++i)
+	{
+		const CXXRecordDecl *record	= m_recordDecls[i];
+		RecordFact &fact			= m_records[i];
+
+		fact.name		= GetRecordName(*record);
+
+		if (IsLogLvl<LogLvl_2>())
+		{
+			fact.shortName = record->getNameAsString();
+		}
+
+		for (const TagDecl *next : record->getFirstDecl()->redecls())
+		{
+			fact.files.push_back(GetFileID(next->getLocation()));
+		}
+	}
+
+	// 2. using¼ڴӡֻ豣
+	if (IsLogLvl<LogLvl_3>())
+	{
+		for (auto &itr : m_usingNamespaces)
+		{
+			m_usingNamespaceNames[itr.first] = itr.second->getQualifiedNameAsString();
+		}
+
+		for (const UsingShadowDecl *usingDecl : m_usings)
+		{
+			m_usingNames.push_back(std::make_pair(usingDecl->getLocation(), usingDecl->getTargetDecl()->getQualifiedNameAsString()));
+		}
+	}
+
+	// 3. ָ﷨
+	m_recordIds.clear();
+	m_recordDecls.clear();
+	m_usingNamespaces.clear();
+	m_usings.clear();
+	m_usingSites.clear();
+	m_usingNamespaceSites.clear();
+	m_usedTypes.clear();
+	m_usedMacros.clear();
+}
+
+// ȡclassstructunionıţ״γʱ
+RecordId ParsingFile::GetRecordId(const CXXRecordDecl *record)
+{
+	auto itr = m_recordIds.find(record);
+	if (itr != m_recordIds.end())
+	{
+		return itr->second;
+	}
+
+	RecordId id = (RecordId)m_recordDecls.size();
+	m_recordIds[record] = id;
+	m_recordDecls.push_back(record);
+	return id;
 }
 
 // ǰcppļ
 void ParsingFile::End()
 {
+	// ģʽͷļѲѽ״̬򱾴νɿãԺ·
+	if (!CheckSkippedBodies())
+	{
+		ProjectHistory::instance.m_retryFiles.push_back(GetFileNameInCache(m_root));
+		return;
+	}
+
 	Analyze();
 	Print();
 	Clean();
@@ -441,12 +1013,7 @@ bool ParsingFile::MergeMinInclude()
 // Ƿûļɱ޸ĵļΪûļΪⲿļ
 inline bool ParsingFile::IsUserFile(FileID file) const
 {
-	bool isUserFile = !IsSystemHeader(file)
-		&& CanClean(file)
-		&& !IsAncestorDefaultInclude(file)
-		&& !IsAncestorSkip(file);
-
-	return isUserFile;
+	return HasFileFlag(file, FileFlag_User);
 }
 
 // Ƿⲿļɱ޸ĵļΪûļΪⲿļ
@@ -474,6 +1041,68 @@ void ParsingFile::GenerateDefaultIncludes()
 	}
 }
 
+// ŰĬϰǿƺԵȱǴݸļÿļıλ
+void ParsingFile::GenerateFileFlags()
+{
+	m_fileFlags.clear();
+
+	// 1. Դͷļռļϵļ㣬IsAncestorByNameһ£
+	FileNameSet defaultIncludeKids;
+	FileNameSet skipKids;
+
+	auto MarkRoots = [&](const FileSet &roots, unsigned flag, FileNameSet &kidNames)
+	{
+		for (FileID root : roots)
+		{
+			m_fileFlags[root] |= flag;
+
+			auto kidItr = m_kidsByName.find(GetLowerFileNameInCache(root));
+			if (kidItr != m_kidsByName.end())
+			{
+				Add(kidNames, kidItr->second);
+			}
+		}
+	};
+
+	MarkRoots(m_defaultIncludes, FileFlag_DefaultInclude, defaultIncludeKids);
+	MarkRoots(m_skips, FileFlag_Skip, skipKids);
+
+	// 2. һαļǴݵļ˳ǷΪûļ
+	for (FileID file : m_files)
+	{
+		unsigned &flags = m_fileFlags[file];
+
+		const char *fileName = GetLowerFileNameInCache(file);
+		if (Has(defaultIncludeKids, fileName))
+		{
+			flags |= FileFlag_DefaultInclude;
+		}
+
+		if (Has(skipKids, fileName))
+		{
+			flags |= FileFlag_Skip;
+		}
+
+		if (!(flags & (FileFlag_DefaultInclude | FileFlag_Skip)) && !IsSystemHeader(file) && CanClean(file))
+		{
+			flags |= FileFlag_User;
+		}
+	}
+}
+
+// ļǷָλ
+inline bool ParsingFile::HasFileFlag(FileID file, unsigned flag) const
+{
+	// ע⣺ЧFileIDDenseMapĿռڲ
+	if (file.isInvalid())
+	{
+		return false;
+	}
+
+	auto itr = m_fileFlags.find(file);
+	return itr != m_fileFlags.end() && (itr->second & flag);
+}
+
 // ȡⲿļ
 void ParsingFile::GenerateOutFileAncestor()
 {
@@ -691,6 +1320,14 @@ bool ParsingFile::IsFileBeforeLoc(FileID a, SourceLocation b) const
 // aļǷbļ֮ǰ
 bool ParsingFile::IsFileBeforeFile(FileID a, FileID b) const
 {
+	// żļȺ˳
+	const IncludeOrder *aOrder = GetIncludeOrder(a);
+	const IncludeOrder *bOrder = GetIncludeOrder(b);
+	if (aOrder && bOrder)
+	{
+		return aOrder->seq < bOrder->seq;
+	}
+
 	SourceLocation aIncludeLoc = m_srcMgr->getIncludeLoc(a);
 	SourceLocation bIncludeLoc = m_srcMgr->getIncludeLoc(b);
 	return isBeforeInTranslationUnit(aIncludeLoc, bIncludeLoc);
@@ -699,62 +1336,54 @@ bool ParsingFile::IsFileBeforeFile(FileID a, FileID b) const
 // ļǷĬϱ
 inline bool ParsingFile::IsAncestorDefaultInclude(FileID file) const
 {
-	for (FileID defaultInclude : m_defaultIncludes)
-	{
-		if (file == defaultInclude || IsAncestorByName(file, defaultInclude))
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return HasFileFlag(file, FileFlag_DefaultInclude);
 }
 
 // ļǷǿƺ
 inline bool ParsingFile::IsAncestorSkip(FileID file) const
 {
-	for (FileID skip : m_skips)
-	{
-		if (file == skip || IsAncestorByName(file, skip))
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return HasFileFlag(file, FileFlag_Skip);
 }
 
 // ȡļȣļΪ0
 int ParsingFile::GetDepth(FileID child) const
 {
-	int depth = 0;
+	const IncludeOrder *order = GetIncludeOrder(child);
+	return order ? order->depth : 0;
+}
 
-	for (FileID parent; (parent = GetParent(child)).isValid(); child = parent)
+// ȡļڰеĴ򣬷أnullptrʾļδ¼
+inline const ParsingFile::IncludeOrder* ParsingFile::GetIncludeOrder(FileID file) const
+{
+	if (file.isInvalid())
 	{
-		++depth;
+		return nullptr;
 	}
 
-	return depth;
+	auto itr = m_includeOrders.find(file);
+	return itr != m_includeOrders.end() ? &itr->second : nullptr;
 }
 
 // ļǷӦõclassstructunionǰ
-bool ParsingFile::IsShouldKeepForwardClass(FileID by, const CXXRecordDecl &cxxRecord) const
+bool ParsingFile::IsShouldKeepForwardClass(FileID by, RecordId record) const
 {
+	const RecordFact &cxxRecord = m_records[record];
+
 	auto IsAnyKidHasRecord = [&](FileID recordAtFile) -> bool
 	{
 		if (Contains(by, recordAtFile))
 		{
-			LogInfoByLvl(LogLvl_2, "[skip record]: record has been contained. by = " << GetDebugFileName(by) << ", file = " << GetDebugFileName(recordAtFile) << ", record = " << cxxRecord.getNameAsString());
+			LogInfoByLvl(LogLvl_2, "[skip record]: record has been contained. by = " << GetDebugFileName(by) << ", file = " << GetDebugFileName(recordAtFile) << ", record = " << cxxRecord.shortName);
 			return true;
 		}
 		else if (IsAncestorDefaultInclude(recordAtFile))
 		{
-			LogInfoByLvl(LogLvl_2, "[skip record]: record is default included: record = [" <<  GetRecordName(cxxRecord) << "], by = " << GetDebugFileName(by) << ", record file = " << GetDebugFileName(recordAtFile));
+			LogInfoByLvl(LogLvl_2, "[skip record]: record is default included: record = [" <<  cxxRecord.name << "], by = " << GetDebugFileName(by) << ", record file = " << GetDebugFileName(recordAtFile));
 			return true;
 		}
 		else if (IsSameName(by, recordAtFile))
 		{
-			LogInfoByLvl(LogLvl_2, "[skip record]: record is at same file: record = [" <<  GetRecordName(cxxRecord) << "], by = " << GetDebugFileName(by) << ", record file = " << GetDebugFileName(recordAtFile));
+			LogInfoByLvl(LogLvl_2, "[skip record]: record is at same file: record = [" <<  cxxRecord.name << "], by = " << GetDebugFileName(by) << ", record file = " << GetDebugFileName(recordAtFile));
 			return true;
 		}
 
@@ -762,10 +1391,8 @@ bool ParsingFile::IsShouldKeepForwardClass(FileID by, const CXXRecordDecl &cxxRe
 	};
 
 	// ļһҪټǰ
-	const TagDecl *first = cxxRecord.getFirstDecl();
-	for (const TagDecl *next : first->redecls())
+	for (FileID recordAtFile : cxxRecord.files)
 	{
-		FileID recordAtFile = GetFileID(next->getLocation());
 		if (IsAnyKidHasRecord(recordAtFile))
 		{
 			return false;
@@ -778,76 +1405,47 @@ bool ParsingFile::IsShouldKeepForwardClass(FileID by, const CXXRecordDecl &cxxRe
 // ǰб
 void ParsingFile::GenerateForwardClass()
 {
-	// 1. һЩȷ֪Ҫඨǰ
-	for (auto &itr : m_fileUseRecordPointers)
+	// 1. һЩȷ֪Ҫඨǰݼ¼Ѱ[ļ, class]ź
+	for (auto groupBeg = m_fileUseRecordPointers.begin(), end = m_fileUseRecordPointers.end(); groupBeg != end;)
 	{
-		FileID by = itr.first;
-		RecordSet &records = itr.second;
+		FileID by = groupBeg->file;
 
-		auto beUseItr = m_fileUseRecords.find(by);
-		if (beUseItr != m_fileUseRecords.end())
+		auto groupEnd = std::find_if(groupBeg, end, [by](const UseRecordItem &use) { return use.file != by; });
+
+		RecordSet records;
+		for (auto itr = groupBeg; itr != groupEnd; ++itr)
 		{
-			const RecordSet &beUseRecords = beUseItr->second;
-			Del(records, beUseRecords);
+			if (!std::binary_search(m_fileUseRecords.begin(), m_fileUseRecords.end(), *itr, IsLessByFileRecord))
+			{
+				records.insert(itr->record);
+			}
 		}
 
 		m_fowardClass[GetFirstFileID(by)] = records;
+		groupBeg = groupEnd;
 	}
 
-	// 2. ɾظǰ
-	MinimizeForwardClass();
+	// 2. ɾҪǰ
+	FilterForwardClass();
 
 	// 3. ļ޷ǰǰֱһŲ
-	bool isAnyForwardError = true;
-	while (isAnyForwardError)
-	{
-		isAnyForwardError = false;
-
-		for (auto &forwardClassItr : m_fowardClass)
-		{
-			FileID by = forwardClassItr.first;
-			
-			// ļ#include˵ԷǰԺ
-			if (Has(m_includes, GetLowerFileNameInCache(by)))
-			{
-				continue;
-			}
-
-			// ע
-			const RecordSet records = forwardClassItr.second;
-
-			for (auto &itr : m_minInclude)
-			{
-				FileID at = itr.first;
-				const FileSet &includes = itr.second;
-
-				if (Has(includes, by))
-				{
-					Add(m_fowardClass[at], records);
-				}
-			}
-
-			isAnyForwardError = true;
-
-			m_fowardClass.erase(by);
-			break;
-		}
-	};
+	MoveUpForwardClass();
 
+	// 4. ɾظǰ
 	MinimizeForwardClass();
 }
 
-// üǰбɾظģ
-void ParsingFile::MinimizeForwardClass()
+// ɾҪǰ
+void ParsingFile::FilterForwardClass()
 {
 	MapEraseIf(m_fowardClass, [&](FileID by, RecordSet &records)
 	{
-		EraseIf(records, [&](const CXXRecordDecl* record)
+		EraseIf(records, [&](RecordId record)
 		{
-			bool should_keep = g_nowFile->IsShouldKeepForwardClass(by, *record);
+			bool should_keep = g_nowFile->IsShouldKeepForwardClass(by, record);
 			if (should_keep)
 			{
-				LogErrorByLvl(LogLvl_2, "IsShouldKeepForwardClass = true: " << GetDebugFileName(by) << "," << GetRecordName(*record));
+				LogErrorByLvl(LogLvl_2, "IsShouldKeepForwardClass = true: " << GetDebugFileName(by) << "," << GetRecordName(record));
 			}
 
 			return !should_keep;
@@ -855,18 +1453,124 @@ void ParsingFile::MinimizeForwardClass()
 
 		return records.empty();
 	});
+}
+
+// ޷ǰļļû#includeеǰһŲ
+void ParsingFile::MoveUpForwardClass()
+{
+	auto HasInclude = [&](FileID file)
+	{
+		return Has(m_includes, GetLowerFileNameInCache(file));
+	};
+
+	// ļЩļֱӰ[ļ] -> [ļļб]
+	std::map<FileID, FileVec> includedBy;
+	for (const auto &itr : m_minInclude)
+	{
+		for (FileID beInclude : itr.second)
+		{
+			includedBy[beInclude].push_back(itr.first);
+		}
+	}
+
+	// ļļ#include˵ԷǰԺԣ
+	FileVec todo;
+	for (const auto &itr : m_fowardClass)
+	{
+		if (!HasInclude(itr.first))
+		{
+			todo.push_back(itr.first);
+		}
+	}
+
+	while (!todo.empty())
+	{
+		FileID by = todo.back();
+		todo.pop_back();
+
+		auto forwardItr = m_fowardClass.find(by);
+		if (forwardItr == m_fowardClass.end())
+		{
+			continue;
+		}
+
+		// ע
+		const RecordSet records = forwardItr->second;
+		m_fowardClass.erase(forwardItr);
+
+		auto parentItr = includedBy.find(by);
+		if (parentItr == includedBy.end())
+		{
+			continue;
+		}
+
+		for (FileID at : parentItr->second)
+		{
+			if (at == by)
+			{
+				continue;
+			}
+
+			RecordSet &atRecords = m_fowardClass[at];
+
+			size_t oldSize = atRecords.size();
+			Add(atRecords, records);
+
+			// ŲļܷͬǰŲ
+			if (atRecords.size() != oldSize && !HasInclude(at))
+			{
+				todo.push_back(at);
+			}
+		}
+	}
+}
+
+// üǰбɾظģ
+void ParsingFile::MinimizeForwardClass()
+{
+	FilterForwardClass();
 
 	// 1. ͳƳÿļǰ[ļ] -> [ļǰ]
 	FileSet all;
-	Add(all, m_fileUseRecordPointers);
-	Add(all, m_minInclude);
+	for (const UseRecordItem &use : m_fileUseRecordPointers)
+	{
+		all.insert(GetFirstFileID(use.file));
+	}
+
+	for (const auto &itr : m_minInclude)
+	{
+		all.insert(GetFirstFileID(itr.first));
+	}
+
+	// һȫļĽļĽֱӸã
+	FileUseRecordsMap forwardsInKids;
+	FileSet visiting;
+	bool isCycle = false;
+
+	for (FileID by : all)
+	{
+		CollectForwardsInKids(by, forwardsInKids, visiting, isCycle);
+		if (isCycle)
+		{
+			break;
+		}
+	}
 
 	FileUseRecordsMap bigForwards;
 
 	for (FileID by : all)
 	{
-		by = GetFirstFileID(by);
-		GetAllForwardsInKids(by, bigForwards[by]);
+		RecordSet &forwards = bigForwards[by];
+
+		// ѭʱļͳ
+		if (isCycle)
+		{
+			GetAllForwardsInKids(by, forwards);
+		}
+		else
+		{
+			forwards = forwardsInKids[by];
+		}
 	}
 
 	m_fowardClass.clear();
@@ -901,6 +1605,47 @@ void ParsingFile::MinimizeForwardClass()
 	}
 }
 
+// һļļǰѭʱisCycleΪtrue
+void ParsingFile::CollectForwardsInKids(FileID top, FileUseRecordsMap &forwardsInKids, FileSet &visiting, bool &isCycle) const
+{
+	if (Has(forwardsInKids, top))
+	{
+		return;
+	}
+
+	if (!visiting.insert(top).second)
+	{
+		isCycle = true;
+		return;
+	}
+
+	RecordSet forwards;
+
+	auto forwardItr = m_fowardClass.find(top);
+	if (forwardItr != m_fowardClass.end())
+	{
+		Add(forwards, forwardItr->second);
+	}
+
+	auto includeItr = m_minInclude.find(top);
+	if (includeItr != m_minInclude.end())
+	{
+		for (FileID kid : includeItr->second)
+		{
+			CollectForwardsInKids(kid, forwardsInKids, visiting, isCycle);
+
+			auto kidItr = forwardsInKids.find(kid);
+			if (kidItr != forwardsInKids.end())
+			{
+				Add(forwards, kidItr->second);
+			}
+		}
+	}
+
+	visiting.erase(top);
+	forwardsInKids[top] = forwards;
+}
+
 // ȡָļļǰб
 void ParsingFile::GetAllForwardsInKids(FileID top, RecordSet &forwards)
 {
@@ -1078,6 +1823,11 @@ inline int ParsingFile::GetLineNo(SourceLocation loc) const
 // ȡļӦıк
 int ParsingFile::GetIncludeLineNo(FileID file) const
 {
+	if (const IncludeOrder *order = GetIncludeOrder(file))
+	{
+		return order->line;
+	}
+
 	if (IsForceInclude(file))
 	{
 		return 0;
@@ -1118,13 +1868,34 @@ inline void ParsingFile::Use(SourceLocation a, SourceLocation b, const char* nam
 	a = GetExpasionLoc(a);
 	b = GetExpasionLoc(b);
 
-	UseInclude(GetFileID(a), GetFileID(b), name, GetLineNo(a));
+	// кŽڴӡҪʱ
+	int line = (IsNeedUseName(name) ? GetLineNo(a) : 0);
+	UseInclude(GetFileID(a), GetFileID(b), name, line);
+}
+
+// ǷҪ¼õƣڴӡ
+inline bool ParsingFile::IsNeedUseName(const char* name) const
+{
+	return IsLogLvl<LogLvl_2>() && nullptr != name;
+}
+
+// ¼[aʹb]أtrueñ״γ֡falseñѼ¼
+inline bool ParsingFile::AddUseEdge(FileID a, FileID b)
+{
+	const FilePair edge(a, b);
+	if (edge == m_lastUseEdge)
+	{
+		return false;
+	}
+
+	m_lastUseEdge = edge;
+	return m_useEdges.insert(edge).second;
 }
 
 // ¼ϵļaļbĳеĳ
 inline void ParsingFile::UseName(FileID file, FileID beusedFile, const char* name /* = nullptr */, int line)
 {
-	if (Project::instance.m_logLvl < LogLvl_2)
+	if (!IsLogLvl<LogLvl_2>())
 	{
 		return;
 	}
@@ -1197,6 +1968,12 @@ inline void ParsingFile::UseInclude(FileID a, FileID b, const char* name /* = nu
 		return;
 	}
 
+	// ͬһļùϵֻ账һΣӡʱҪÿõƣ
+	if (!AddUseEdge(a, b) && !IsNeedUseName(name))
+	{
+		return;
+	}
+
 	if (nullptr == m_srcMgr->getFileEntryForID(a) || nullptr == m_srcMgr->getFileEntryForID(b))
 	{
 		LogErrorByLvl(LogLvl_Max, "m_srcMgr->getFileEntryForID(a) failed!" << m_srcMgr->getFilename(m_srcMgr->getLocForStartOfFile(a)) << ":" << m_srcMgr->getFilename(m_srcMgr->getLocForStartOfFile(b)));
@@ -1215,19 +1992,32 @@ inline void ParsingFile::UseInclude(FileID a, FileID b, const char* name /* = nu
 // ǰλʹָĺ
 void ParsingFile::UseMacro(SourceLocation loc, const MacroDefinition &macro, const Token &macroNameTok, const MacroArgs *args /* = nullptr */)
 {
-	if (IsInSystemHeader(loc))
+	MacroInfo *info = macro.getMacroInfo();
+	if (nullptr == info)
 	{
 		return;
 	}
 
-	MacroInfo *info = macro.getMacroInfo();
-	if (info)
+	// ע⣺ļд#lineָʱǷλϵͳͷļλñ仯ȥж
+	if (IsInSystemHeader(loc))
 	{
-		std::string name;
-		GetNameForLog(name, macroNameTok.getIdentifierInfo()->getName().str() << "[macro]");
+		return;
+	}
 
-		Use(loc, info->getDefinitionLoc(), name.c_str());
+	// ͬһļظͬһʱһģֻһαӡϸ־ʱҪÿһãԲ
+	if (!IsLogLvl<LogLvl_2>())
+	{
+		FileID file = GetFileID(loc);
+		if (file.isValid() && !m_usedMacros.insert(FileMacroUse(file, info)).second)
+		{
+			return;
+		}
 	}
+
+	std::string name;
+	GetNameForLog(name, macroNameTok.getIdentifierInfo()->getName().str() << "[macro]");
+
+	Use(loc, info->getDefinitionLoc(), name.c_str());
 }
 
 void ParsingFile::UseContext(SourceLocation loc, const DeclContext *context)
@@ -1275,162 +2065,71 @@ bool ParsingFile::isBeforeInTranslationUnit(SourceLocation LHS, SourceLocation R
 	if (LHS == RHS)
 		return false;
 
-	// ںļҳb
-	auto CompareLocInSameFile = [&](bool isLeftLow, SourceLocation lowLoc, SourceLocation highLoc)
-	{
-		int lowOffset = m_srcMgr->getFileOffset(lowLoc);
-		int highOffset = m_srcMgr->getFileOffset(highLoc);
-
-		return isLeftLow ? lowOffset < highOffset : highOffset < lowOffset;
-	};
-
-	bool isLeftLow = true;
-
-	SourceLocation lowLoc = LHS;
-	SourceLocation highLoc = RHS;
+	FileID lhsFile = GetFileID(LHS);
+	FileID rhsFile = GetFileID(RHS);
 
-	FileID lowFile = GetFileID(LHS);
-	FileID highFile = GetFileID(RHS);
-
-	int low = GetDepth(lowFile);
-	int high = GetDepth(highFile);
-
-	//LogInfo("===>" << GetLowerFileNameInCache(lowFile) << ", deep = " << low);
-	//LogInfo("===>" << GetLowerFileNameInCache(highFile) << ", deep = " << high);
-
-	if (low < high)
+	if (lhsFile == rhsFile)
 	{
-		isLeftLow = false;
-
-		std::swap(low, high);
-		std::swap(lowLoc, highLoc);
-		std::swap(lowFile, highFile);
+		return m_srcMgr->getFileOffset(LHS) < m_srcMgr->getFileOffset(RHS);
 	}
 
-	if (lowFile == highFile)
+	const IncludeOrder *lhsOrder = GetIncludeOrder(lhsFile);
+	const IncludeOrder *rhsOrder = GetIncludeOrder(rhsFile);
+	if (nullptr == lhsOrder || nullptr == rhsOrder)
 	{
-		return CompareLocInSameFile(isLeftLow, lowLoc, highLoc);
+		return false;
 	}
 
-	for (int up = 0; high + up < low ; ++up)
+	// ǷǺļļűļĺ
+	auto IsKid = [](const IncludeOrder &kid, const IncludeOrder &ancestor)
+	{
+		return ancestor.seq < kid.seq && kid.seq <= ancestor.lastKid;
+	};
+
+	// ҵļļֱ#includeǸļ
+	auto GetKidOf = [&](FileID kid, const IncludeOrder &kidOrder, const IncludeOrder &ancestorOrder)
 	{
-		FileID lowParent = GetParent(lowFile);
-		if (lowParent == highFile)
+		for (int up = ancestorOrder.depth + 1; up < kidOrder.depth; ++up)
 		{
-			return CompareLocInSameFile(isLeftLow, m_srcMgr->getIncludeLoc(lowFile), highLoc);
+			kid = GetParent(kid);
 		}
 
-		lowFile = lowParent;
-	}
+		return kid;
+	};
 
-	for (int up = 0; up < high; ++up)
+	// ұļļĺȽλӦļ#includeλ
+	if (IsKid(*rhsOrder, *lhsOrder))
 	{
-		FileID lowParent = GetParent(lowFile);
-		FileID highParent = GetParent(highFile);
-
-		if (lowParent == highParent)
-		{
-			return CompareLocInSameFile(isLeftLow, m_srcMgr->getIncludeLoc(lowFile), m_srcMgr->getIncludeLoc(highFile));
-		}
+		FileID kid = GetKidOf(rhsFile, *rhsOrder, *lhsOrder);
+		return m_srcMgr->getFileOffset(LHS) < m_srcMgr->getFileOffset(m_srcMgr->getIncludeLoc(kid));
+	}
 
-		lowFile = lowParent;
-		highFile = highParent;
+	// ļұļĺ
+	if (IsKid(*lhsOrder, *rhsOrder))
+	{
+		FileID kid = GetKidOf(lhsFile, *lhsOrder, *rhsOrder);
+		return m_srcMgr->getFileOffset(m_srcMgr->getIncludeLoc(kid)) < m_srcMgr->getFileOffset(RHS);
 	}
 
-	return false;
+	// ļȫһһֱӱȽ
+	return lhsOrder->seq < rhsOrder->seq;
 }
 
 // using namespace
 bool ParsingFile::UseUsingNamespace(SourceLocation loc, const NamespaceDecl *beUseNs, bool mustAncestor)
 {
-	if (m_usingNamespaces.empty())
+	auto sitesItr = m_usingNamespaceSites.find(beUseNs->getCanonicalDecl());
+	if (sitesItr == m_usingNamespaceSites.end())
 	{
 		return false;
 	}
 
 	loc = GetExpasionLoc(loc);
-	
-	FileID file = GetFileID(loc);
-	const std::string beUseNsName = beUseNs->getQualifiedNameAsString();
-
-	SourceLocation bestUsingLoc;
-	const NamespaceDecl	*bestNs = nullptr;
-
-	if (mustAncestor)
-	{
-		// 1. Ȳͬļڵusing namespace
-		auto itr = m_usingNamespacesByFile.find(file);
-		if (itr != m_usingNamespacesByFile.end())
-		{
-			const UsingNamespaceLocMap &nsMap = itr->second;
-
-			for (auto nsItr : nsMap)
-			{
-				SourceLocation usingLoc = nsItr.first;
-				const NamespaceDecl	*ns = nsItr.second;
-
-				if (ns->getQualifiedNameAsString() == beUseNsName && isBeforeInTranslationUnit(usingLoc, loc))
-				{
-					bestUsingLoc = usingLoc;
-					bestNs = ns;
-					break;
-				}
-			}
-		}
 
-		// 2. 򣬲Һļusing namespace
-		if (bestNs == nullptr)
-		{
-			auto includeItr = m_includes.find(GetLowerFileNameInCache(file));
-			if (includeItr != m_includes.end())
-			{
-				const FileSet &includeList = includeItr->second;
-				for (FileID beInclude : includeList)
-				{
-					for (auto nsByFileItr : m_usingNamespacesByFile)
-					{
-						FileID usingAtFile = nsByFileItr.first;
-
-						if (!IsAncestorByName(usingAtFile, file))
-						{
-							continue;
-						}
-
-						const UsingNamespaceLocMap &nsMap = nsByFileItr.second;
-
-						for (auto nsItr : nsMap)
-						{
-							SourceLocation usingLoc = nsItr.first;
-							const NamespaceDecl	*ns = nsItr.second;
-
-							if (ns->getQualifiedNameAsString() == beUseNsName && isBeforeInTranslationUnit(usingLoc, loc))
-							{
-								bestUsingLoc = usingLoc;
-								bestNs = ns;
-								break;
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-	else
-	{
-		// ֮ǰļusing namespace
-		for (auto itr : m_usingNamespaces)
-		{
-			SourceLocation usingLoc = itr.first;
-			const NamespaceDecl	*ns = itr.second;
+	const UsingSite *best = FindUsingSite(sitesItr->second, loc, mustAncestor);
 
-			if (ns->getQualifiedNameAsString() == beUseNsName && isBeforeInTranslationUnit(usingLoc, loc))
-			{
-				bestUsingLoc = usingLoc;
-				bestNs = ns;
-				break;
-			}
-		}
-	}
+	SourceLocation bestUsingLoc = (best ? best->loc : SourceLocation());
+	const NamespaceDecl	*bestNs = (best ? cast<NamespaceDecl>(best->decl) : nullptr);
 
 	// ҳɹ
 	if (bestNs)
@@ -1448,104 +2147,122 @@ bool ParsingFile::UseUsingNamespace(SourceLocation loc, const NamespaceDecl *beU
 // using
 bool ParsingFile::UseUsing(SourceLocation loc, const NamedDecl *nameDecl, bool mustAncestor)
 {
-	const UsingVec &usingVec = m_usings;
-	if (usingVec.empty())
+	auto sitesItr = m_usingSites.find(GetUsingTargetKey(nameDecl));
+	if (sitesItr == m_usingSites.end())
 	{
 		return false;
 	}
 
+	// ҵõusing
+	const UsingSite *best = FindUsingSite(sitesItr->second, GetExpasionLoc(loc), mustAncestor);
+	const UsingShadowDecl *bestUsingDecl = (best ? cast<UsingShadowDecl>(best->decl) : nullptr);
+
+	// ҳɹ
+	if (bestUsingDecl)
+	{
+		std::string name;
+		GetNameForLog(name, "using " << bestUsingDecl->getQualifiedNameAsString() << "[" << bestUsingDecl->getDeclKindName() << "]");
+
+		// øusing
+		Use(loc, bestUsingDecl->getLocation(), name.c_str());
+		return true;
+	}
+
+	return false;
+}
+
+// ڱ뵥ԪеȺ󣬽usingλò뵽б
+void ParsingFile::AddUsingSite(UsingSites &sites, SourceLocation loc, FileID file, const NamedDecl *decl) const
+{
+	UsingSite site;
+	site.loc	= loc;
+	site.file	= file;
+	site.decl	= decl;
+
+	// ׷ӵĩβ
+	auto pos = std::upper_bound(sites.begin(), sites.end(), site, [&](const UsingSite &a, const UsingSite &b)
+	{
+		return isBeforeInTranslationUnit(a.loc, b.loc);
+	});
+
+	sites.insert(pos, site);
+}
+
+// ڰȺеusingбвҵǰλÿõusingأnullptrʾδҵ
+const ParsingFile::UsingSite* ParsingFile::FindUsingSite(const UsingSites &sites, SourceLocation loc, bool mustAncestor) const
+{
 	FileID file = GetFileID(loc);
 
-	// ҵõusing
-	const UsingShadowDecl *bestUsingDecl = nullptr;
+	// λڵǰλ֮ǰusingбһǰ׺ֲҳǰ׺
+	auto beforeEnd = std::partition_point(sites.begin(), sites.end(), [&](const UsingSite &site)
+	{
+		return isBeforeInTranslationUnit(site.loc, loc);
+	});
+
+	if (!mustAncestor)
+	{
+		// ֮ǰļusing
+		return sites.begin() != beforeEnd ? &sites.front() : nullptr;
+	}
+
+	// 1. Ȳͬļڵusing
+	for (auto itr = sites.begin(); itr != beforeEnd; ++itr)
+	{
+		if (itr->file == file)
+		{
+			return &*itr;
+		}
+	}
 
-	const std::string beUsingName = nameDecl->getQualifiedNameAsString();
+	// 2. 򣬲ҺļusingжļʱȡFileIDļļȡǰusing
+	const UsingSite *best = nullptr;
 
-	if (mustAncestor)
+	if (Has(m_includes, GetLowerFileNameInCache(file)))
 	{
-		// 1. Ȳͬļڵusing
-		auto itr = m_usingsByFile.find(file);
-		if (itr != m_usingsByFile.end())
+		for (auto itr = sites.begin(); itr != beforeEnd; ++itr)
 		{
-			const UsingVec &vecUsingAtFile = itr->second;
-
-			for (const UsingShadowDecl *usingDecl : vecUsingAtFile)
+			if (best && !(best->file < itr->file))
 			{
-				NamedDecl *usingNameDecl = usingDecl->getTargetDecl();
-				SourceLocation usingLoc = usingDecl->getLocation();
-
-				if (usingNameDecl->getQualifiedNameAsString() == beUsingName && isBeforeInTranslationUnit(usingLoc, loc))
-				{
-					bestUsingDecl = usingDecl;
-					break;
-				}
+				continue;
 			}
-		}
 
-		// 2. Һļusing
-		if (nullptr == bestUsingDecl)
-		{
-			auto includeItr = m_includes.find(GetLowerFileNameInCache(file));
-			if (includeItr != m_includes.end())
+			if (IsAncestorByName(itr->file, file))
 			{
-				const FileSet &includeList = includeItr->second;
-				for (FileID beInclude : includeList)
-				{
-					for (auto usingByFileItr : m_usingsByFile)
-					{
-						FileID usingAtFile = usingByFileItr.first;
-
-						if (!IsAncestorByName(usingAtFile, file))
-						{
-							continue;
-						}
-
-						const UsingVec &vecUsingAtFile = usingByFileItr.second;
-
-						for (const UsingShadowDecl *usingDecl : vecUsingAtFile)
-						{
-							NamedDecl *usingNameDecl = usingDecl->getTargetDecl();
-							SourceLocation usingLoc = usingDecl->getLocation();
-
-							if (usingNameDecl->getQualifiedNameAsString() == beUsingName && isBeforeInTranslationUnit(usingLoc, loc))
-							{
-								bestUsingDecl = usingDecl;
-								break;
-							}
-						}
-					}
-				}
+				best = &*itr;
 			}
 		}
 	}
-	else
+
+	return best;
+}
+
+// ȡusingĿеļģػʵ鵽ģ屾
+const NamedDecl* ParsingFile::GetUsingTargetKey(const NamedDecl *target)
+{
+	if (const ClassTemplateSpecializationDecl *spec = dyn_cast<ClassTemplateSpecializationDecl>(target))
+	{
+		target = spec->getSpecializedTemplate();
+	}
+	else if (const CXXRecordDecl *record = dyn_cast<CXXRecordDecl>(target))
 	{
-		// ֮ǰļusing
-		for (const UsingShadowDecl *usingDecl : usingVec)
+		if (const ClassTemplateDecl *templateDecl = record->getDescribedClassTemplate())
 		{
-			NamedDecl *usingNameDecl = usingDecl->getTargetDecl();
-			SourceLocation usingLoc = usingDecl->getLocation();
-
-			if (usingNameDecl->getQualifiedNameAsString() == beUsingName && isBeforeInTranslationUnit(usingLoc, loc))
-			{
-				bestUsingDecl = usingDecl;
-				break;
-			}
+			target = templateDecl;
 		}
 	}
-
-	// ҳɹ
-	if (bestUsingDecl)
+	else if (const FunctionDecl *func = dyn_cast<FunctionDecl>(target))
 	{
-		std::string name;
-		GetNameForLog(name, "using " << bestUsingDecl->getQualifiedNameAsString() << "[" << bestUsingDecl->getDeclKindName() << "]");
-
-		// øusing
-		Use(loc, bestUsingDecl->getLocation(), name.c_str());
-		return true;
+		if (const FunctionTemplateDecl *templateDecl = func->getPrimaryTemplate())
+		{
+			target = templateDecl;
+		}
+		else if (const FunctionTemplateDecl *describedDecl = func->getDescribedFunctionTemplate())
+		{
+			target = describedDecl;
+		}
 	}
 
-	return false;
+	return cast<NamedDecl>(target->getCanonicalDecl());
 }
 
 // ռ
@@ -1557,7 +2274,7 @@ void ParsingFile::UseNamespaceAliasDecl(SourceLocation loc, const NamespaceAlias
 // ռ
 void ParsingFile::DeclareNamespace(const NamespaceDecl *d)
 {
-	if (Project::instance.m_logLvl >= LogLvl_2)
+	if (IsLogLvl<LogLvl_2>())
 	{
 		SourceLocation loc = GetSpellingLoc(d->getLocation());
 
@@ -1630,8 +2347,14 @@ void ParsingFile::UsingNamespace(const UsingDirectiveDecl *d)
 		// ռڵļע⣺using namespaceʱҵӦnamespace磬using namespace AǰһҪnamespace A{}ᱨ
 		Use(usingLoc, nsLoc, name.c_str());
 
-		m_usingNamespaces[usingLoc] = bestNs;
-		m_usingNamespacesByFile[GetFileID(usingLoc)][usingLoc] = bestNs;
+		if (m_usingNamespaces.insert(std::make_pair(usingLoc, bestNs)).second)
+		{
+			// ڱ뵥ԪеȺ뵽
+			AddUsingSite(m_usingNamespaceSites[bestNs->getCanonicalDecl()], usingLoc, atFileID, bestNs);
+
+			// ˺ÿܻõusing·ֽ
+			m_usedTypes.clear();
+		}
 	}
 }
 
@@ -1649,7 +2372,11 @@ void ParsingFile::UsingXXX(const UsingDecl *d)
 		}
 
 		m_usings.push_back(shadowDecl);
-		m_usingsByFile[GetFileID(usingLoc)].push_back(shadowDecl);
+		// 뵥ԪеȺ򣬺ڵusingȡչλòܲȽ
+		AddUsingSite(m_usingSites[GetUsingTargetKey(nameDecl)], GetExpasionLoc(shadowDecl->getLocation()), GetFileID(usingLoc), shadowDecl);
+
+		// ˺ÿܻõusing·ֽ
+		m_usedTypes.clear();
 
 		std::string name;
 		GetNameForLog(name, "using " << shadowDecl->getQualifiedNameAsString() << "[" << nameDecl->getQualifiedNameAsString() << "]" << "[" << nameDecl->getDeclKindName() << "]");
@@ -1689,6 +2416,32 @@ std::string ParsingFile::GetNestedNamespace(const NamespaceDecl *d)
 
 // aʹbʱ跨ҵһaϹϵbⲿ
 FileID ParsingFile::GetBestAncestor(FileID a, FileID b) const
+{
+	if (a.isInvalid() || b.isInvalid())
+	{
+		return SearchBestAncestor(a, b);
+	}
+
+	// ҹֻõaļͬaɹһβҽ
+	FilePair key(GetFirstFileID(a), b);
+	if (key.first.isInvalid())
+	{
+		return SearchBestAncestor(a, b);
+	}
+
+	auto itr = m_bestAncestors.find(key);
+	if (itr != m_bestAncestors.end())
+	{
+		return itr->second;
+	}
+
+	FileID best = SearchBestAncestor(a, b);
+	m_bestAncestors[key] = best;
+	return best;
+}
+
+// aĺļ£ҳbⲿȣGetBestAncestorãᱻ棩
+FileID ParsingFile::SearchBestAncestor(FileID a, FileID b) const
 {
 	if (!IsOuterFile(b))
 	{
@@ -1704,11 +2457,20 @@ FileID ParsingFile::GetBestAncestor(FileID a, FileID b) const
 	{
 		FileID search = a;
 
+		// ѾļͬļͳһΪһαʱļID
 		FileSet done;
 
 		// ںļҳb
 		auto SearchInKid = [&](FileID now, FileID b)
 		{
+			// £ĺδֱʹ
+			FileID kid = GetKidOnPath(now, b);
+			if (kid.isInvalid() || !Has(done, GetFirstFileID(kid)))
+			{
+				return kid;
+			}
+
+			// 򣨴ѭѾĺ
 			auto itr = m_includes.find(GetLowerFileNameInCache(now));
 			if (itr == m_includes.end())
 			{
@@ -1718,17 +2480,7 @@ FileID ParsingFile::GetBestAncestor(FileID a, FileID b) const
 			const FileSet &includes = itr->second;
 			for (FileID beInclude : includes)
 			{
-				bool isDone = false;
-				for (FileID doneFile : done)
-				{
-					if (IsSameName(doneFile, beInclude))
-					{
-						isDone = true;
-						break;
-					}
-				}
-
-				if (isDone)
+				if (Has(done, GetFirstFileID(beInclude)))
 				{
 					continue;
 				}
@@ -1751,7 +2503,7 @@ FileID ParsingFile::GetBestAncestor(FileID a, FileID b) const
 			}
 
 			search = kid;
-			done.insert(search);
+			done.insert(GetFirstFileID(search));
 
 			if (IsOuterFile(search))
 			{
@@ -1772,6 +2524,45 @@ FileID ParsingFile::GetBestAncestor(FileID a, FileID b) const
 	}
 }
 
+// ļĺҳһͨbļbbȣأЧIDʾδҵ
+FileID ParsingFile::GetKidOnPath(FileID now, FileID b) const
+{
+	// ֻȡļļļֻһ
+	FilePair key(GetFirstFileID(now), GetFirstFileID(b));
+	bool canCache = (key.first.isValid() && key.second.isValid());
+
+	if (canCache)
+	{
+		auto pathItr = m_kidsOnPath.find(key);
+		if (pathItr != m_kidsOnPath.end())
+		{
+			return pathItr->second;
+		}
+	}
+
+	FileID kid;
+
+	auto itr = m_includes.find(GetLowerFileNameInCache(now));
+	if (itr != m_includes.end())
+	{
+		for (FileID beInclude : itr->second)
+		{
+			if (IsAncestorByName(b, beInclude) || IsSameName(b, beInclude))
+			{
+				kid = beInclude;
+				break;
+			}
+		}
+	}
+
+	if (canCache)
+	{
+		m_kidsOnPath[key] = kid;
+	}
+
+	return kid;
+}
+
 // ǰλʹĿͣעTypeĳͣconstvolatilestaticȵΣ
 void ParsingFile::UseType(SourceLocation loc, const Type *t, const NestedNameSpecifier *specifier /* = nullptr */)
 {
@@ -1780,6 +2571,16 @@ void ParsingFile::UseType(SourceLocation loc, const Type *t, const NestedNameSpe
 		return;
 	}
 
+	// ͬһļظͬһʱֽһģٵݹֽ⣨עӡϸ־ʱҪÿһãԲ
+	if (!IsLogLvl<LogLvl_2>())
+	{
+		FileID file = GetFileID(loc);
+		if (file.isValid() && !m_usedTypes.insert(FileTypeUse(file, t, specifier)).second)
+		{
+			return;
+		}
+	}
+
 	// ʹõtypedefͣ磺typedef int dworddwordTypedefType
 	if (isa<TypedefType>(t))
 	{
@@ -2018,15 +2819,20 @@ inline void ParsingFile::UseForward(SourceLocation loc, const CXXRecordDecl *cxx
 	bool isOpenForward = false;
     if (isOpenForward)
 	{
+		UseRecordItem use;
+		use.file	= by;
+		use.loc		= loc;
+		use.record	= GetRecordId(cxxRecord);
+
 		// ļʹõǰ¼
-		m_fileUseRecordPointers[by].insert(cxxRecord);
+		m_fileUseRecordPointers.push_back(use);
 
 		SearchUsingAny(loc, specifier, cxxRecord);
 		UseQualifier(loc, cxxRecord->getQualifier());
 
-		if (Project::instance.m_logLvl >= LogLvl_2)
+		if (IsLogLvl<LogLvl_2>())
 		{
-			m_locUseRecordPointers[loc].insert(cxxRecord);
+			m_locUseRecordPointers.push_back(use);
 		}  
 	}
 	else
@@ -2034,9 +2840,14 @@ inline void ParsingFile::UseForward(SourceLocation loc, const CXXRecordDecl *cxx
 		SearchUsingAny(loc, specifier, cxxRecord);
 		UseQualifier(loc, cxxRecord->getQualifier());
 
-		if (Project::instance.m_logLvl >= LogLvl_2)
+		if (IsLogLvl<LogLvl_2>())
 		{
-			m_locUseRecordPointers[loc].insert(cxxRecord);
+			UseRecordItem use;
+			use.file	= by;
+			use.loc		= loc;
+			use.record	= GetRecordId(cxxRecord);
+
+			m_locUseRecordPointers.push_back(use);
 		}
     }
 }
@@ -2117,36 +2928,54 @@ void ParsingFile::UseVarType(SourceLocation loc, const QualType &var, const Nest
 		QualType pointeeType = GetPointeeType(var); 
 		const CXXRecordDecl *cxxRecordDecl = pointeeType->getAsCXXRecordDecl();
 
-		// ⲿļвǰ
-		if (IsOuterFile(GetFileID(loc)))
+		// ʽʱBegin֮ǰ֪ЩûļȼBeginٴ
+		if (!m_isBegun)
 		{
-			FileID at = GetFileID(loc);
+			PendingForwardUse use;
+			use.loc			= loc;
+			use.record		= cxxRecordDecl;
+			use.specifier	= specifier;
 
-			for (const TagDecl *redecl : cxxRecordDecl->redecls())
-			{
-				SourceLocation recordLoc = redecl->getBeginLoc();
-				FileID recordFile = GetFileID(recordLoc);
+			m_pendingForwardUses.push_back(use);
+			return;
+		}
+
+		UseForwardType(loc, cxxRecordDecl, specifier);
+	}
+	else
+	{
+		//var->dump();
+		UseQualType(loc, var, specifier);
+	}
+}
+
+// ÿǰָࣨ롢ãⲿļΪ౾ûļΪǰ
+void ParsingFile::UseForwardType(SourceLocation loc, const CXXRecordDecl *cxxRecordDecl, const NestedNameSpecifier *specifier)
+{
+	// ⲿļвǰ
+	if (IsOuterFile(GetFileID(loc)))
+	{
+		FileID at = GetFileID(loc);
+
+		for (const TagDecl *redecl : cxxRecordDecl->redecls())
+		{
+			SourceLocation recordLoc = redecl->getBeginLoc();
+			FileID recordFile = GetFileID(recordLoc);
 
-				if (isBeforeInTranslationUnit(recordLoc, loc))
+			if (isBeforeInTranslationUnit(recordLoc, loc))
+			{
+				if (IsAncestorByName(recordFile, at) || IsSameName(recordFile, at))
 				{
-					if (IsAncestorByName(recordFile, at) || IsSameName(recordFile, at))
-					{
-						return;
-					}
+					return;
 				}
 			}
-
-			UseRecord(loc, cxxRecordDecl);
-		}
-		else
-		{
-			UseForward(loc, cxxRecordDecl, specifier);
 		}
+
+		UseRecord(loc, cxxRecordDecl);
 	}
 	else
 	{
-		//var->dump();
-		UseQualType(loc, var, specifier);
+		UseForward(loc, cxxRecordDecl, specifier);
 	}
 }
 
@@ -2385,8 +3214,12 @@ void ParsingFile::UseRecord(SourceLocation loc, const RecordDecl *record)
 
 	if (isa<CXXRecordDecl>(record))
 	{
-		const CXXRecordDecl *cxxRecord = cast<CXXRecordDecl>(record);
-		m_fileUseRecords[by].insert(cxxRecord);
+		UseRecordItem use;
+		use.file	= by;
+		use.loc		= loc;
+		use.record	= GetRecordId(cast<CXXRecordDecl>(record));
+
+		m_fileUseRecords.push_back(use);
 	}
 
 	std::string name;
@@ -2405,7 +3238,8 @@ inline bool ParsingFile::IsSystemHeader(FileID file) const
 // ָλǷϵͳͷļڣ<vector><iostream>Ⱦϵͳļ
 bool ParsingFile::IsInSystemHeader(SourceLocation loc) const
 {
-	return m_srcMgr->isInSystemHeader(loc);
+	const LocCache *cache = GetLocCache(loc);
+	return (cache && !cache->hasLineDirectives) ? cache->isSystem : m_srcMgr->isInSystemHeader(loc);
 }
 
 // Ƿc++ļļݲκα仯
@@ -2604,12 +3438,57 @@ inline SourceLocation ParsingFile::GetSpellingLoc(SourceLocation loc) const
 // ȡչλ
 inline SourceLocation ParsingFile::GetExpasionLoc(SourceLocation loc) const
 {
-	return m_srcMgr->getExpansionLoc(loc);
+	if (loc.isFileID())
+	{
+		return loc;
+	}
+
+	const LocCache *cache = GetLocCache(loc);
+	return cache ? cache->expansionLoc : m_srcMgr->getExpansionLoc(loc);
+}
+
+// ѯλû棬δʱͨSourceManagerѯˢ»棬أnullptrʾλ޷
+inline const ParsingFile::LocCache* ParsingFile::GetLocCache(SourceLocation loc) const
+{
+	if (loc.isInvalid())
+	{
+		return nullptr;
+	}
+
+	// ļλλ÷ֿ棬Ϊ߳
+	LocCache &cache = (loc.isFileID() ? m_fileLocCache : m_macroLocCache);
+
+	SourceLocation::UIntTy raw = loc.getRawEncoding();
+	if (cache.beg <= raw && raw < cache.end)
+	{
+		return &cache;
+	}
+
+	std::pair<FileID, unsigned> decomposed = m_srcMgr->getDecomposedLoc(loc);
+	if (decomposed.first.isInvalid())
+	{
+		return nullptr;
+	}
+
+	// ע⣺ͬһSLocEntryڵλãչλͬϵͳͨҲͬļкָʱ#pragma GCC system_headerƫƶ䣬ʱϵͳ
+	cache.file				= decomposed.first;
+	cache.beg				= raw - decomposed.second;
+	cache.end				= cache.beg + m_srcMgr->getFileIDSize(cache.file) + 1;
+	cache.expansionLoc		= (loc.isFileID() ? SourceLocation() : m_srcMgr->getExpansionLoc(loc));
+	cache.hasLineDirectives	= (loc.isFileID() && m_srcMgr->getSLocEntry(cache.file).getFile().hasLineDirectives());
+	cache.isSystem			= (cache.hasLineDirectives ? false : m_srcMgr->isInSystemHeader(loc));
+	return &cache;
 }
 
 // ȡļID
 inline FileID ParsingFile::GetFileID(SourceLocation loc) const
 {
+	const LocCache *cache = GetLocCache(loc);
+	if (cache)
+	{
+		return cache->file;
+	}
+
 	FileID fileID = m_srcMgr->getFileID(loc);
 	if (fileID.isInvalid())
 	{
@@ -3095,8 +3974,7 @@ std::string ParsingFile::AddPrintIdx() const
 // ӡϢ
 void ParsingFile::Print()
 {
-	LogLvl verbose = Project::instance.m_logLvl;
-	if (verbose <= LogLvl_0)
+	if (!IsLogLvl<LogLvl_1>())
 	{
 		return;
 	}
@@ -3110,12 +3988,12 @@ void ParsingFile::Print()
 
 	m_printIdx = 0;
 
-	if (verbose >= LogLvl_1)
+	if (IsLogLvl<LogLvl_1>())
 	{
 		PrintHistory();
 	}
 
-	if (verbose >= LogLvl_2)
+	if (IsLogLvl<LogLvl_2>())
 	{
 		PrintMinInclude();
 		PrintMinKid();
@@ -3127,7 +4005,7 @@ void ParsingFile::Print()
 		PrintSameFile();
 	}
 
-	if (verbose >= LogLvl_3)
+	if (IsLogLvl<LogLvl_3>())
 	{
 		PrintOutFileAncestor();
 		PrintKidsByName();
@@ -3238,7 +4116,7 @@ void ParsingFile::TakeDel(FileHistory &history, const FileSet &dels) const
 		delLine.end		= m_srcMgr->getFileOffset(lineRange.getEnd());
 		delLine.text	= GetSourceOfLine(lineRange.getBegin());
 
-		if (Project::instance.m_logLvl >= LogLvl_2)
+		if (IsLogLvl<LogLvl_2>())
 		{
 			SourceRange nextLine = GetNextLine(m_srcMgr->getIncludeLoc(del));
 			LogInfo("TakeDel [" << history.m_filename << "]: line = " << line << "[" << delLine.beg << "," << m_srcMgr->getFileOffset(nextLine.getBegin())
@@ -3296,9 +4174,9 @@ void ParsingFile::TakeForwardClass(FileHistory &history, FileID insertAfter, Fil
 
 	// ʼȡǰϢ
 	const RecordSet &cxxRecords = useRecordItr->second;
-	for (const CXXRecordDecl *cxxRecord : cxxRecords)
+	for (RecordId cxxRecord : cxxRecords)
 	{
-		forwardLine.classes.insert(GetRecordName(*cxxRecord));
+		forwardLine.classes.insert(GetRecordName(cxxRecord));
 	}
 }
 
@@ -3359,59 +4237,96 @@ void ParsingFile::SortAddFiles(FileID top, FileSet &adds, FileSet &keeps, FileSe
 	// ǰѱĺļб
 	FileSet alreadyIncludes;
 
+	// ļδ[ļ] -> [δļ]
+	std::map<FileID, int> waitCounts;
+
+	// ȴĳļļб[ļ] -> [ȴļļб]
+	std::map<FileID, FileVec> waiters;
+
+	// ѱ㡢ԲļļIDСβ룩
+	FileSet ready;
+
+	auto IncludeOne = [&](FileID beInclude)
+	{
+		if (!alreadyIncludes.insert(beInclude).second)
+		{
+			return;
+		}
+
+		// ѵȴļļ
+		auto waiterItr = waiters.find(beInclude);
+		if (waiterItr == waiters.end())
+		{
+			return;
+		}
+
+		for (FileID waiter : waiterItr->second)
+		{
+			if (--waitCounts[waiter] == 0)
+			{
+				ready.insert(waiter);
+			}
+		}
+
+		waiters.erase(waiterItr);
+	};
+
 	auto AddAlreadyIncludes = [&](FileID file)
 	{
 		file = GetFirstFileID(file);
-		alreadyIncludes.insert(file);
+		IncludeOne(file);
 
 		auto itr = m_minKids.find(file);
 		if (itr != m_minKids.end())
 		{
-			const FileSet &kids = itr->second;
-			Add(alreadyIncludes, kids);
+			for (FileID kid : itr->second)
+			{
+				IncludeOne(kid);
+			}
 		}
 	};
 
-	// ǰļǷɱ루Ҫǰļļѱ
-	auto CanInsert = [&](FileID file) -> bool
+	// ȡǰļδļѱǵǰļĺʱΪ㣩
+	auto GetUnmetUses = [&](FileID file, FileVec &unmet)
 	{
 		auto useItr = m_userUses.find(GetLowerFileNameInCache(file));
+		if (useItr == m_userUses.end())
+		{
+			return;
+		}
+
 		auto kidItr = m_minKids.find(file);
 
-		if (useItr != m_userUses.end())
+		for (FileID beUse : useItr->second)
 		{
-			const FileSet &useList = useItr->second;
-			for (FileID beUse : useList)
+			if (Has(alreadyIncludes, beUse))
 			{
-				bool can = Has(alreadyIncludes, beUse);
-				if (!can)
-				{
-					if (kidItr != m_minKids.end())
-					{
-						can = Has(kidItr->second, beUse);
-					}
-				}
+				continue;
+			}
 
-				if (!can)
-				{
-					LogInfoByLvl(LogLvl_3, "CanInsert = false, " << GetLowerFileNameInCache(file));
-					return false;
-				}
+			if (kidItr != m_minKids.end() && Has(kidItr->second, beUse))
+			{
+				continue;
 			}
 
-			LogInfoByLvl(LogLvl_3, "CanInsert = true, " << GetLowerFileNameInCache(file));
-			return true;
-		}
-		else
-		{
-			LogInfoByLvl(LogLvl_3, "CanInsert = true, " << GetLowerFileNameInCache(file));
-			return true;
+			unmet.push_back(beUse);
 		}
+	};
 
-		return false;
+	// ǰļǷɱ루Ҫǰļļѱ
+	auto CanInsert = [&](FileID file) -> bool
+	{
+		FileVec unmet;
+		GetUnmetUses(file, unmet);
+
+		LogInfoByLvl(LogLvl_3, "CanInsert = " << unmet.empty() << ", " << GetLowerFileNameInCache(file));
+		return unmet.empty();
 	};
 
-	auto GetInsertFile = [&](FileID file, const FileSet &finalKeeps) -> FileID
+	// ļȶӦıļ[ļӦĵһļID] -> [ļ]ļļͬ
+	std::map<FileID, FileID> keepByName;
+
+	auto GetInsertFile = [&](FileID file) -> FileID
 	{
 		auto useItr = m_userUses.find(GetLowerFileNameInCache(file));
 		if (useItr == m_userUses.end())
@@ -3425,44 +4340,14 @@ void ParsingFile::SortAddFiles(FileID top, FileSet &adds, FileSet &keeps, FileSe
 
 		for (FileID beUse : useList)
 		{
-			FileID sameNameFile;
-
-			for (FileID keep : finalKeeps)
-			{
-				if (IsSameName(keep, beUse))
-				{
-					LogInfoByLvl(LogLvl_3, "IsSameName = " << GetLowerFileNameInCache(keep) << ", at = " << DebugBeIncludeText(keep));
-					sameNameFile = keep;
-					break;
-				}
-
-				auto kidItr = m_minKids.find(GetFirstFileID(keep));
-				if (kidItr != m_minKids.end())
-				{
-					const FileSet &kids = kidItr->second;
-
-					for (FileID kid : kids)
-					{
-						if (IsSameName(kid, beUse))
-						{
-							LogInfoByLvl(LogLvl_3, "IsSameName kid = " << GetLowerFileNameInCache(kid) << ", at = " << DebugBeIncludeText(keep));
-							sameNameFile = keep;
-							break;
-						}
-					}
-				}
-
-				if (sameNameFile.isValid())
-				{
-					break;
-				}
-			}
-
-			if (sameNameFile.isInvalid())
+			auto keepItr = keepByName.find(GetFirstFileID(beUse));
+			if (keepItr == keepByName.end())
 			{
 				continue;
 			}
 
+			FileID sameNameFile = keepItr->second;
+
 			LogInfoByLvl(LogLvl_3, "IsFileBeforeFile(insertFile, sameNameFile) = " << IsFileBeforeFile(insertFile, sameNameFile) << ", " << DebugBeIncludeText(insertFile));
 			LogInfoByLvl(LogLvl_3, "IsFileBeforeFile(insertFile, sameNameFile) = " << IsFileBeforeFile(insertFile, sameNameFile) << ", " << DebugBeIncludeText(sameNameFile));
 			
@@ -3476,7 +4361,7 @@ void ParsingFile::SortAddFiles(FileID top, FileSet &adds, FileSet &keeps, FileSe
 		return insertFile;
 	};
 
-	//------ ʼÿļԼļһԹȥļ ------//
+	//------ ʼÿļԼļļ루ϵ ------//
 
 	FileSet &remainAdds = adds;
 
@@ -3498,43 +4383,63 @@ void ParsingFile::SortAddFiles(FileID top, FileSet &adds, FileSet &keeps, FileSe
 		}
 	}
 
-	while (!remainAdds.empty())
+	// ļ˳򣬼¸ļȶӦıļ
+	for (FileID keep : finalKeeps)
 	{
-		int before_size = (int)remainAdds.size();
-		LogInfoByLvl(LogLvl_3, "before_size = " << before_size);
+		keepByName.insert(std::make_pair(GetFirstFileID(keep), keep));
 
-		for (FileID add : remainAdds)
+		auto kidItr = m_minKids.find(GetFirstFileID(keep));
+		if (kidItr != m_minKids.end())
 		{
-			if (CanInsert(add))
+			for (FileID kid : kidItr->second)
 			{
-				FileID insertFile = GetInsertFile(add, finalKeeps);
-				if (insertFile.isValid())
-				{
-					lastInsert = insertFile;
-				}
+				keepByName.insert(std::make_pair(GetFirstFileID(kid), keep));
+			}
+		}
+	}
 
-				LogInfoByLvl(LogLvl_3, "ok add = " << GetLowerFileNameInCache(add) << ", insert at = " << GetLowerFileNameInCache(lastInsert));
+	// ǼǸļδ
+	for (FileID add : remainAdds)
+	{
+		FileVec unmet;
+		GetUnmetUses(add, unmet);
 
-				if (Has(keeps, add))
-				{
-					dels.insert(add);
-				}
+		if (unmet.empty())
+		{
+			ready.insert(add);
+			continue;
+		}
 
-				remainAdds.erase(add);
+		waitCounts[add] = (int)unmet.size();
 
-				inserts[lastInsert].push_back(add);
-				AddAlreadyIncludes(add);
-				break;
-			}
+		for (FileID beUse : unmet)
+		{
+			waiters[beUse].push_back(add);
 		}
+	}
 
-		int after_size = (int)remainAdds.size();
-		LogInfoByLvl(LogLvl_3, "after_size = " << after_size);
+	while (!ready.empty())
+	{
+		FileID add = *ready.begin();
+		ready.erase(ready.begin());
 
-		if (after_size >= before_size)
+		FileID insertFile = GetInsertFile(add);
+		if (insertFile.isValid())
 		{
-			break;
+			lastInsert = insertFile;
+		}
+
+		LogInfoByLvl(LogLvl_3, "ok add = " << GetLowerFileNameInCache(add) << ", insert at = " << GetLowerFileNameInCache(lastInsert));
+
+		if (Has(keeps, add))
+		{
+			dels.insert(add);
 		}
+
+		remainAdds.erase(add);
+
+		inserts[lastInsert].push_back(add);
+		AddAlreadyIncludes(add);
 	}
 
 	Del(remainAdds, keeps);
@@ -3556,6 +4461,7 @@ FileID ParsingFile::CalcInsertLoc(const FileSet &includes, const FileSet &dels)
 	FileID firstInclude;
 	int firstIncludeLineNo = 0;
 
+	// кAddFileʱԤ
 	auto SearchFirstInclude = [&](FileID a)
 	{
 		int line = GetIncludeLineNo(a);
@@ -3835,42 +4741,66 @@ bool ParsingFile::IsNeedPrintFile(FileID file) const
 // ӡתΪǰָü¼
 void ParsingFile::PrintUseRecord() const
 {
-	// 1. ļǰ¼ļй
-	UseRecordsByFileMap recordMap;
+	// ¼Ѱ[ļ, λ, class]źͬļͬλõļ¼
+	const UseRecordVec &records = m_locUseRecordPointers;
+
+	auto GetFileEnd = [&](UseRecordVec::const_iterator beg)
+	{
+		return std::find_if(beg, records.end(), [&](const UseRecordItem &use) { return use.file != beg->file; });
+	};
 
-	for (auto &itr : m_locUseRecordPointers)
+	// 1. ͳļ
+	int fileCount = 0;
+	for (auto fileBeg = records.begin(); fileBeg != records.end(); fileBeg = GetFileEnd(fileBeg))
 	{
-		SourceLocation loc	= itr.first;
-		FileID file	= GetFileID(loc);
-		recordMap[file].insert(itr);
+		if (fileBeg->file.isValid())
+		{
+			++fileCount;
+		}
 	}
-	recordMap.erase(FileID());
 
 	// 2. ӡ
 	HtmlDiv &div = HtmlLog::instance->m_newDiv;
-	div.AddRow(AddPrintIdx() + ". use records list: file count = " + get_number_html(recordMap.size()), 1);
+	div.AddRow(AddPrintIdx() + ". use records list: file count = " + get_number_html(fileCount), 1);
 
-	for (auto &itr : recordMap)
+	for (auto fileBeg = records.begin(); fileBeg != records.end();)
 	{
-		FileID file = itr.first;
-		const LocUseRecordsMap &locToRecords = itr.second;
+		FileID file = fileBeg->file;
+		auto fileEnd = GetFileEnd(fileBeg);
 
-		div.AddRow(DebugParentFileText(file, locToRecords.size()), 2);
+		if (file.isInvalid())
+		{
+			fileBeg = fileEnd;
+			continue;
+		}
 
-		for (auto &recordItr : locToRecords)
+		int locCount = 0;
+		for (auto itr = fileBeg; itr != fileEnd; ++itr)
 		{
-			SourceLocation loc = recordItr.first;
-			const std::set<const CXXRecordDecl*> &cxxRecords = recordItr.second;
+			if (itr == fileBeg || itr->loc != (itr - 1)->loc)
+			{
+				++locCount;
+			}
+		}
 
-			div.AddRow("at loc = " + DebugLocText(loc), 3);
+		div.AddRow(DebugParentFileText(file, locCount), 2);
 
-			for (const CXXRecordDecl *record : cxxRecords)
+		for (auto itr = fileBeg; itr != fileEnd; ++itr)
+		{
+			if (itr == fileBeg || itr->loc != (itr - 1)->loc)
 			{
-				div.AddRow("use record = " + GetRecordName(*record), 4);
+				div.AddRow("at loc = " + DebugLocText(itr->loc), 3);
 			}
 
-			div.AddRow("");
+			div.AddRow("use record = " + GetRecordName(itr->record), 4);
+
+			if (itr + 1 == fileEnd || itr->loc != (itr + 1)->loc)
+			{
+				div.AddRow("");
+			}
 		}
+
+		fileBeg = fileEnd;
 	}
 }
 
@@ -3892,9 +4822,9 @@ void ParsingFile::PrintForwardClass() const
 
 		div.AddRow(DebugParentFileText(by, records.size()), 2);
 
-		for (const CXXRecordDecl *record : records)
+		for (RecordId record : records)
 		{
-			div.AddRow("add forward class = " + GetRecordName(*record), 3);
+			div.AddRow("add forward class = " + GetRecordName(record), 3);
 		}
 
 		div.AddRow("");
@@ -3940,7 +4870,7 @@ void ParsingFile::PrintHistory() const
 			continue;
 		}
 
-		if (Project::instance.m_logLvl < LogLvl_2)
+		if (!IsLogLvl<LogLvl_2>())
 		{
 			if (!cpptool::is_cpp(history.m_filename))
 			{
@@ -3983,12 +4913,12 @@ void ParsingFile::PrintNamespace() const
 void ParsingFile::PrintUsingNamespace() const
 {
 	std::map<FileID, std::set<std::string>>	nsByFile;
-	for (auto &itr : m_usingNamespaces)
+	for (auto &itr : m_usingNamespaceNames)
 	{
 		SourceLocation loc		= itr.first;
-		const NamespaceDecl	*ns	= itr.second;
+		const std::string &ns	= itr.second;
 
-		nsByFile[GetFileID(loc)].insert(ns->getQualifiedNameAsString());
+		nsByFile[GetFileID(loc)].insert(ns);
 	}
 
 	HtmlDiv &div = HtmlLog::instance->m_newDiv;
@@ -4021,9 +4951,9 @@ void ParsingFile::PrintUsingXXX() const
 	HtmlDiv &div = HtmlLog::instance->m_newDiv;
 	div.AddRow(AddPrintIdx() + ". each file's using xxx", 1);
 
-	for (const UsingShadowDecl* usingDecl : m_usings)
+	for (auto &itr : m_usingNames)
 	{
-		SourceLocation loc = usingDecl->getLocation();
+		SourceLocation loc = itr.first;
 		FileID file = GetFileID(loc);
 		
 		if (!IsNeedPrintFile(file))
@@ -4031,10 +4961,8 @@ void ParsingFile::PrintUsingXXX() const
 			continue;
 		}
 
-		NamedDecl *usingNameDecl = usingDecl->getTargetDecl();
-
 		div.AddRow("at loc = " + DebugLocText(loc), 2);
-		div.AddRow("using xxx = " + get_include_html(usingNameDecl->getQualifiedNameAsString()), 3);
+		div.AddRow("using xxx = " + get_include_html(itr.second), 3);
 	}
 }
 
@@ -4093,9 +5021,9 @@ void ParsingFile::PrintMinInclude() const
 		if (forwardItr != m_fowardClass.end())
 		{
 			const RecordSet &forwards = forwardItr->second;
-			for (const CXXRecordDecl *record : forwards)
+			for (RecordId record : forwards)
 			{
-				div.AddRow("add forward class = " + GetRecordName(*record), 3);
+				div.AddRow("add forward class = " + GetRecordName(record), 3);
 			}
 		}
 
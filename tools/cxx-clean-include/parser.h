@@ -10,9 +10,14 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <tuple>
+#include <scoped_allocator>
 #include <clang/Basic/SourceLocation.h>
 #include <clang/Basic/SourceManager.h>
 #include <clang/Rewrite/Core/Rewriter.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/Support/Allocator.h>
 #include "history.h"
 
 using namespace std;
@@ -48,26 +53,105 @@ namespace clang
 	class SourceManager;
 }
 
+// ǰcppļڴأParsingFileгڴڵΪֵĽڵ䣬ParsingFileһͷ
+class FileArena
+{
+public:
+	llvm::BumpPtrAllocator* Get() { return &m_allocator; }
+
+private:
+	llvm::BumpPtrAllocator m_allocator;
+};
+
+// ָڴطstlĬϹʱʹڴأͨĶѷ䣨ʱˣ꼴ͷţ
+template <typename T>
+struct ArenaAllocator
+{
+	typedef T value_type;
+
+	ArenaAllocator()
+		: arena(nullptr)
+	{}
+
+	ArenaAllocator(llvm::BumpPtrAllocator *arena)
+		: arena(arena)
+	{}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other)
+		: arena(other.arena)
+	{}
+
+	// Ϊʱڴ
+	ArenaAllocator select_on_container_copy_construction() const
+	{
+		return ArenaAllocator();
+	}
+
+	T* allocate(std::size_t n)
+	{
+		if (arena)
+		{
+			return static_cast<T*>(arena->Allocate(n * sizeof(T), llvm::Align(alignof(T))));
+		}
+
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, std::size_t)
+	{
+		// ڴеڴֻڴʱͷ
+		if (nullptr == arena)
+		{
+			::operator delete(p);
+		}
+	}
+
+	llvm::BumpPtrAllocator *arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena == b.arena; }
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena != b.arena; }
+
+// ڵɴڴطset
+template <typename Key>
+using ArenaSet = std::set<Key, std::less<Key>, ArenaAllocator<Key>>;
+
+// ڵɴڴطmapֵΪArenaSetֵڵĽڵҲͬһڴط䣨scoped_allocator_adaptorѷֵĹ캯
+template <typename Key, typename Val>
+using ArenaMap = std::map<Key, Val, std::less<Key>, std::scoped_allocator_adaptor<ArenaAllocator<std::pair<const Key, Val>>>>;
+
 // [ļ] -> [·ϵͳ·û·]
 typedef std::map<string, SrcMgr::CharacteristicKind> IncludeDirMap;
 
+// classstructunionıţӦParsingFile::m_records±꣩
+typedef int RecordId;
+
 // classstructunion
-typedef std::set<const CXXRecordDecl*> RecordSet;
+typedef ArenaSet<RecordId> RecordSet;
 
 // usingб
 typedef std::vector<const UsingShadowDecl*> UsingVec;
 
-// [λ] -> [ʹõclassstructûָ]
-typedef std::map<SourceLocation, RecordSet> LocUseRecordsMap;
-
 // [ļ] -> [ʹõclassstructûָ]
-typedef std::map<FileID, RecordSet> FileUseRecordsMap;
+typedef ArenaMap<FileID, RecordSet> FileUseRecordsMap;
 
-// [ļ] -> [ļʹõclassstructunionָ]
-typedef std::map<FileID, LocUseRecordsMap> UseRecordsByFileMap;
+// ʹclassstructunionļ¼[ļ, λ, ʹõclassstructunion]
+struct UseRecordItem
+{
+	FileID					file;
+	SourceLocation			loc;
+	RecordId				record;
+};
+
+// ʹü¼бڼֻ׷ӣǰͳһȥأ
+typedef std::vector<UseRecordItem> UseRecordVec;
 
 // ļ
-typedef std::set<FileID> FileSet;
+typedef ArenaSet<FileID> FileSet;
 
 // ļб
 typedef std::vector<FileID> FileVec;
@@ -75,6 +159,35 @@ typedef std::vector<FileID> FileVec;
 // ļ
 typedef std::set<std::string> FileNameSet;
 
+// ļλBegin׶һ֮ĲѯΪO(1)
+enum FileFlag
+{
+	FileFlag_DefaultInclude	= 1 << 0,	// ļȱĬϰ-includeǿưԤͷļ
+	FileFlag_Skip			= 1 << 1,	// ļȱ-skipѡǿƺ
+	FileFlag_User			= 1 << 2,	// ûļɱ޸ĵļ
+};
+
+// [ļID] -> [ļλ]
+typedef llvm::DenseMap<FileID, unsigned> FileFlagMap;
+
+// ļԣ磺(ļa, ļb)ʾaʹb
+typedef std::pair<FileID, FileID> FilePair;
+
+// ļԼ
+typedef llvm::DenseSet<FilePair> FilePairSet;
+
+// ĳļĳͣ(ļ, , ǰ)
+typedef std::tuple<FileID, const Type*, const NestedNameSpecifier*> FileTypeUse;
+
+// ļü
+typedef llvm::DenseSet<FileTypeUse> FileTypeUseSet;
+
+// ĳļĳ꣺(ļ, 궨)
+typedef std::pair<FileID, const MacroInfo*> FileMacroUse;
+
+// ļü
+typedef llvm::DenseSet<FileMacroUse> FileMacroUseSet;
+
 // setset
 template <typename Container1, typename Container2>
 inline void Add(Container1 &a, const Container2 &b)
@@ -83,8 +196,8 @@ inline void Add(Container1 &a, const Container2 &b)
 }
 
 // setmap
-template <typename Key, typename Val>
-inline void Add(std::set<Key> &a, const std::map<Key, Val> &b)
+template <typename Key, typename Cmp, typename Alloc, typename Val, typename MapCmp, typename MapAlloc>
+inline void Add(std::set<Key, Cmp, Alloc> &a, const std::map<Key, Val, MapCmp, MapAlloc> &b)
 {
 	for (const auto &itr : b)
 	{
@@ -129,6 +242,86 @@ class ParsingFile
 		const NamespaceDecl	*ns;		// ռĶ
 	};
 
+	// λòѯ棺¼ĳSLocEntryռƫ估ѯͬһڵλپSourceManagerĶֲ
+	struct LocCache
+	{
+		LocCache()
+			: beg(0)
+			, end(0)
+			, isSystem(false)
+			, hasLineDirectives(false)
+		{}
+
+		SourceLocation::UIntTy	beg;			// ʼλõԭʼ룬
+		SourceLocation::UIntTy	end;			// λõԭʼ룬
+		FileID					file;			// ӦFileID
+		SourceLocation			expansionLoc;	// չλãԺЧ
+		bool					isSystem;		// չڵļǷΪϵͳļhasLineDirectivesΪfalseʱЧ
+		bool					hasLineDirectives;	// ļǷкָ#pragma GCC system_header# N "f" 3ʱϵͳƫƶ䣬ܰ仺
+	};
+
+	// ͷļ#pragma once#include
+	struct SkippedInclude
+	{
+		SourceLocation	loc;		// #includeļλãλparentУ
+		FileID			parent;		// #includeڵļ
+		FileID			kid;		// ļ״αʱļID
+	};
+
+	// ʽʱƳٴָ롢
+	struct PendingForwardUse
+	{
+		SourceLocation				loc;
+		const CXXRecordDecl*		record;
+		const NestedNameSpecifier*	specifier;
+	};
+
+	// using namespaceusingλ
+	struct UsingSite
+	{
+		SourceLocation			loc;	// usingλ
+		FileID					file;	// ļ
+		const NamedDecl*		decl;	// using namespaceӦnamespaceusingӦUsingShadowDecl
+	};
+
+	// usingбڱ뵥ԪеȺУ
+	typedef std::vector<UsingSite> UsingSites;
+
+	// classstructunionĿգ﷨ɣ׶ֻõЩϢ
+	struct RecordFact
+	{
+		std::string				name;		// ȫGetRecordName
+		std::string				shortName;	// ڴӡ
+		FileVec					files;		// ڵļ
+	};
+
+	// ļڰеĴAddFileʱһڿٱȽλõȺ
+	struct IncludeOrder
+	{
+		IncludeOrder()
+			: depth(0)
+			, seq(0)
+			, lastKid(0)
+			, line(0)
+		{}
+
+		int		depth;		// ȣļΪ0
+		int		seq;		// 뵥ԪеţļȺ˳
+		int		lastKid;	// ļţļʱseq
+		int		line;		// #includeкţǿưļΪ0
+	};
+
+	// ͷļ·ǰ׺Ľڵ㣺ÿӦ·еһΣ/ָ
+	struct HeaderSearchNode
+	{
+		HeaderSearchNode()
+			: dir(-1)
+		{}
+
+		std::vector<std::pair<std::string, int>>	kids;	// ӽڵ㣺[·] -> [ڵ]
+		int											dir;	// ڴ˽ͷļ·-1ʾû
+	};
+
 public:
 	// ͷļ·
 	struct HeaderSearchDir
@@ -152,18 +345,51 @@ public:
 	// ӳԱļ
 	void AddFile(FileID file);
 
+	// ĳļ#includeͷļ#pragma once
+	void AddSkippedFile(SourceLocation loc, const FileEntry *entry);
+
+	// ģʽһָ#if#elif#ifdef#ifndefֵvalueΪ'1''0''-'δֵ
+	void AddCondition(SourceLocation loc, char value);
+
+	// ʽʱÿһ#includeϵ͸ļĺļBeginһͬ
+	void AddKidByName(const std::string &parent, const std::string &kid);
+
+	// ¼һ#includeϵ
+	void AddInclude(FileID parent, FileID kid);
+
 	// ǰcppļʼ
 	void Begin();
 
+	// ﷨ȡݣ˺ٷ﷨﷨ͷ
+	void TakeSnapshot();
+
+	// ģʽ¼±ηֻļⲿͷļ
+	void TakeResolvedHeaders() const;
+
+	// ģʽλõĺǷڵòӰ쵱ǰ뵥Ԫķ
+	bool IsSkipFunctionBody(SourceLocation loc);
+
+	// ģʽͷļļǷжѽʱͬ
+	bool CheckSkippedBodies() const;
+
+	// ģʽȡͷļڱηе״̬ļ
+	ResolvedHeader GetHeaderState(const std::string &header) const;
+
 	// ǰcppļ
 	void End();
 
 	// 
 	void Analyze();
 
+	// ڼ׷ӵʹü¼ȥ
+	void SortUseRecords();
+
 	// ļ
 	int GetDeepth(FileID file) const;
 
+	// ȡͬһļֻһΣ
+	inline int GetUseEdgeCount() const { return (int)m_useEdges.size(); }
+
 	// ǷΪǰ
 	bool IsForwardType(const QualType &var);
 
@@ -182,6 +408,9 @@ public:
 	// ʹñ¼
 	void UseVarType(SourceLocation loc, const QualType &var, const NestedNameSpecifier *specifier = nullptr);
 
+	// ÿǰָࣨ롢ãⲿļΪ౾ûļΪǰ
+	void UseForwardType(SourceLocation loc, const CXXRecordDecl *cxxRecordDecl, const NestedNameSpecifier *specifier);
+
 	// ù캯
 	void UseConstructor(SourceLocation loc, const CXXConstructorDecl *constructor);
 
@@ -250,6 +479,15 @@ public:
 	// using
 	bool UseUsing(SourceLocation loc, const NamedDecl*, bool mustAncestor);
 
+	// ڱ뵥ԪеȺ󣬽usingλò뵽б
+	void AddUsingSite(UsingSites &sites, SourceLocation loc, FileID file, const NamedDecl *decl) const;
+
+	// ڰȺеusingбвҵǰλÿõusingأnullptrʾδҵ
+	const UsingSite* FindUsingSite(const UsingSites &sites, SourceLocation loc, bool mustAncestor) const;
+
+	// ȡusingĿеļģػʵ鵽ģ屾
+	static const NamedDecl* GetUsingTargetKey(const NamedDecl *target);
+
 	// ռ
 	void UseNamespaceAliasDecl(SourceLocation loc, const NamespaceAliasDecl*);
 
@@ -268,6 +506,12 @@ public:
 	// aʹbʱ跨ҵһaϹϵbⲿ
 	inline FileID GetBestAncestor(FileID a, FileID b) const;
 
+	// aĺļ£ҳbⲿȣGetBestAncestorãᱻ棩
+	FileID SearchBestAncestor(FileID a, FileID b) const;
+
+	// ļĺҳһͨbļbbȣأЧIDʾδҵ
+	FileID GetKidOnPath(FileID now, FileID b) const;
+
 	// ʼļĶc++Դļ
 	void Clean();
 
@@ -325,6 +569,9 @@ private:
 	// ȡļȣļĸ߶Ϊ0
 	int GetDepth(FileID child) const;
 
+	// ȡļڰеĴ򣬷أnullptrʾļδ¼
+	inline const IncludeOrder* GetIncludeOrder(FileID file) const;
+
 	// ȡָλеı
 	std::string GetSourceOfLine(SourceLocation loc) const;
 
@@ -371,6 +618,12 @@ private:
 	// ¼ϵļaļbĳеĳ
 	inline void UseName(FileID file, FileID beusedFile, const char* name = nullptr, int line = 0);
 
+	// ǷҪ¼õƣڴӡ
+	inline bool IsNeedUseName(const char* name) const;
+
+	// ¼[aʹb]أtrueñ״γ֡falseñѼ¼
+	inline bool AddUseEdge(FileID a, FileID b);
+
 	// ȡļļûиļ
 	FileID GetParent(FileID child) const;
 
@@ -378,6 +631,12 @@ private:
 	// 磺CCռAеռBأnamespace A{ namespace B{ class C; }}
 	string GetRecordName(const RecordDecl &recordDecl) const;
 
+	// ȡc++classstructunionȫȡԿգ
+	inline const std::string& GetRecordName(RecordId record) const { return m_records[record].name; }
+
+	// ȡclassstructunionıţ״γʱ
+	RecordId GetRecordId(const CXXRecordDecl *record);
+
 	// ʹǰ¼ڲҪӵǰ֮
 	inline void UseForward(SourceLocation loc, const CXXRecordDecl *cxxRecordDecl, const NestedNameSpecifier *specifier = nullptr);
 
@@ -403,6 +662,9 @@ private:
 	// ȡļID
 	inline FileID GetFileID(SourceLocation loc) const;
 
+	// ѯλû棬δʱͨSourceManagerѯˢ»棬أnullptrʾλ޷
+	inline const LocCache* GetLocCache(SourceLocation loc) const;
+
 	// ȡ1ļ#include2ļı
 	std::string GetRelativeIncludeStr(FileID f1, FileID f2) const;
 
@@ -410,6 +672,12 @@ private:
 	// 磺ͷļ·"d:/a/b/c" "d:/a/b/c/d/e.h" -> "d/e.h"
 	string GetQuotedIncludeStr(const char *absoluteFilePath) const;
 
+	// ͷļ·б·ǰ׺
+	void GenerateHeaderSearchTrie();
+
+	// ҳ·ƥͷļ·prefixLenƥ䲿ֵĳȣأnullptrʾδҵ
+	const HeaderSearchDir* GetLongestHeaderSearchDir(const std::string &path, size_t &prefixLen) const;
+
 	// 滻ָΧı
 	void ReplaceText(FileID file, int beg, int end, const char* text);
 
@@ -475,7 +743,7 @@ private:
 	FileID GetFileIDByFileName(const char *fileName) const;
 
 	// ļǷӦõclassstructunionǰ
-	bool IsShouldKeepForwardClass(FileID, const CXXRecordDecl &cxxRecord) const;
+	bool IsShouldKeepForwardClass(FileID, RecordId record) const;
 
 	// ɾļֵtrueɾfalseδɾ
 	bool CutInclude(FileID top, FileSet &done, FileSet &includes);
@@ -495,6 +763,12 @@ private:
 	// Ĭϱļб
 	void GenerateDefaultIncludes();
 
+	// ŰĬϰǿƺԵȱǴݸļÿļıλ
+	void GenerateFileFlags();
+
+	// ļǷָλ
+	inline bool HasFileFlag(FileID file, unsigned flag) const;
+
 	// ⲿļȼ¼
 	void GenerateOutFileAncestor();
 
@@ -507,12 +781,21 @@ private:
 	// ǰб
 	void GenerateForwardClass();
 
+	// ɾҪǰ
+	void FilterForwardClass();
+
+	// ޷ǰļļû#includeеǰһŲ
+	void MoveUpForwardClass();
+
 	// üǰбɾظģ
 	void MinimizeForwardClass();
 
 	// ȡָļļǰб
 	void GetAllForwardsInKids(FileID top, RecordSet &forwards);
 
+	// һļļǰѭʱisCycleΪtrue
+	void CollectForwardsInKids(FileID top, FileUseRecordsMap &forwardsInKids, FileSet &visiting, bool &isCycle) const;
+
 	// ȡļĿɾ#include
 	void TakeDel(FileHistory &history, const FileSet &dels) const;
 
@@ -609,13 +892,17 @@ public:
 	// ǰڽļ
 	static ParsingFile *g_nowFile;
 
-	//================== շ ==================//
+	//================== [ڴ] ==================//
 private:
+	// ļڴأλԱ֮ǰڸ죬ڸ
+	FileArena									m_arena;
+
+	//================== շ ==================//
 	// [շ]. ǰcppļĽ[c++ļ] -> [ļ]
 	FileHistoryMap								m_historys;
 
 	// ļСļб[ļID] -> [ļӦֱӰļIDб]
-	std::map<FileID, FileSet>					m_minInclude;
+	ArenaMap<FileID, FileSet>					m_minInclude;
 
 	// ÿļӦǰ
 	FileUseRecordsMap							m_fowardClass;
@@ -626,17 +913,26 @@ private:
 	// ļĺļб[ļ] -> [ļȫļ]
 	std::map<std::string, FileNameSet>			m_kidsByName;
 
+	// ʽʱļЩļֱӰذϸºļ[ļ] -> [ֱӰļļ]
+	std::map<std::string, FileNameSet>			m_includersByName;
+
+	// ʽʱBegin֮ǰָ롢ãõûļǣƳٵBeginд
+	std::vector<PendingForwardUse>				m_pendingForwardUses;
+
+	// BeginǷִУڴ֮ǰûļⲿļȵȱǾδ
+	bool										m_isBegun;
+
 	// ļӦĺļб[ļID] -> [ļӦĺļIDб]
-	std::map<FileID, FileSet>					m_minKids;
+	ArenaMap<FileID, FileSet>					m_minKids;
 
 	// ûļбɱ޸ĵļΪûļΪⲿļ磬ĳļ#include <vector>Ϊ<vector>ǿļֹĶvectorⲿļ
 	FileSet										m_userFiles;
 
 	// ⲿļⲿļ[ļID] -> [ӦⲿļID]
-	std::map<FileID, FileID>					m_outFileAncestor;
+	ArenaMap<FileID, FileID>					m_outFileAncestor;
 
 	// Ŀļùϵ[ûļ] -> [õûļIDб + ⲿļIDб]
-	std::map<std::string, FileSet>				m_userUses;
+	ArenaMap<std::string, FileSet>				m_userUses;
 
 	// ĬϱļIDбЩļкļ޸ģ
 	FileSet										m_defaultIncludes;
@@ -644,43 +940,78 @@ private:
 	// ǿƺԵļIDбЩļкļ޸ģ
 	FileSet										m_skips;
 
+	// GetBestAncestorĲѯ棺[(ļaһαʱļID, ļb)] -> [bⲿ]
+	mutable llvm::DenseMap<FilePair, FileID>	m_bestAncestors;
+
+	// SearchBestAncestorʱ·棺[(ļһαʱļID, ļbһαʱļID)] -> [ļĺеһͨbļ]
+	mutable llvm::DenseMap<FilePair, FileID>	m_kidsOnPath;
+
+	// ļıλ[ļID] -> [FileFlag]
+	FileFlagMap									m_fileFlags;
+
 
 	//================== [ԭʼ] ==================//
 private:
 	//------ 1. ϵ ------//
 
 	// ļļļ¼[ļID] -> [õļб]磬A.hõB.hеclass BΪA.hB.h
-	std::map<FileID, FileSet>					m_uses;
+	ArenaMap<FileID, FileSet>					m_uses;
+
+	// Ѵߣڹظã[(ļa, ļb)]
+	FilePairSet									m_useEdges;
+
+	// һδߣôͬһļ
+	FilePair									m_lastUseEdge;
+
+	// ѵݹֽãͬһļٴͬһʱֱÿһusing¼գΪusingӰֽ
+	FileTypeUseSet								m_usedTypes;
+
+	// Ѵĺãͬһļٴͬһʱֱ
+	FileMacroUseSet								m_usedMacros;
 
 	// ڴӡļʹõȵƼ¼[ļID] -> [ļʹõļе]
 	std::map<FileID, std::vector<UseNameInfo>>	m_useNames;
 
 	//------ 2. ʹࡢṹļ¼ ------//
 
-	// ÿλʹõclassstructָ롢ãǰ[λ] -> [ʹõclassstructunionָ]
-	LocUseRecordsMap							m_locUseRecordPointers;
+	// ڴӡÿλʹõclassstructָ롢ã[ļ, λ, class]
+	UseRecordVec								m_locUseRecordPointers;
+
+	// ÿļʹõclassstructָ롢ãǰ[ļ, class]Ҳظ
+	UseRecordVec								m_fileUseRecordPointers;
 
-	// ÿļʹõclassstructָ롢ãǰ[ļ] -> [ʹõclassstructunionָ]
-	FileUseRecordsMap							m_fileUseRecordPointers;
+	// ÿļʹõclassstructָ롢ãڱɶǰ[ļ, class]Ҳظ
+	UseRecordVec								m_fileUseRecords;
 
-	// ÿļʹõclassstructָ롢ãڱɶǰ
-	FileUseRecordsMap							m_fileUseRecords;
+	// ﷨ڼ䣺classstructunionӦıţɿպգ
+	llvm::DenseMap<const CXXRecordDecl*, RecordId>	m_recordIds;
+
+	// ﷨ڼ䣺ŶӦclassstructunionɿպգ
+	std::vector<const CXXRecordDecl*>			m_recordDecls;
+
+	// ŶӦclassstructunion
+	std::vector<RecordFact>						m_records;
 
 	//------ 3. usingйصļ¼ ------//
 
-	// using namespace¼磺using namespace std;[using namespaceλ] -> [Ӧnamespace]
+	// using namespace¼磺using namespace std;[using namespaceλ] -> [Ӧnamespace]ɿպգ
 	typedef map<SourceLocation, const NamespaceDecl*> UsingNamespaceLocMap;
 	map<SourceLocation, const NamespaceDecl*>	m_usingNamespaces;
 
-	// ļеusing namespace¼
-	map<FileID, UsingNamespaceLocMap>			m_usingNamespacesByFile;
+	// ռusing namespace¼[namespaceĹ淶] -> [using namespaceбڱ뵥ԪеȺУ]ɿպգ
+	llvm::DenseMap<const NamespaceDecl*, UsingSites>	m_usingNamespaceSites;
 	
-	// using¼磺using std::string;[usingĿӦλ] -> [using]
+	// using¼磺using std::string;[usingĿӦλ] -> [using]ɿպգ
 	UsingVec									m_usings;
 
-	// ļеusing¼
-	typedef std::map<FileID, UsingVec> UsingByFileMap;
-	UsingByFileMap								m_usingsByFile;
+	// Ŀusing¼[usingĿ] -> [usingбڱ뵥ԪеȺУ]ɿպգ
+	llvm::DenseMap<const NamedDecl*, UsingSites>		m_usingSites;
+
+	// ڴӡusing namespaceգ[using namespaceλ] -> [ռȫ]
+	std::map<SourceLocation, std::string>		m_usingNamespaceNames;
+
+	// ڴӡusingգ[usingλ, usingĿȫ]б
+	std::vector<std::pair<SourceLocation, std::string>>	m_usingNames;
 
 	// ڴӡļռ¼[ļ] -> [ļڵռ¼]
 	std::map<FileID, std::set<std::string>>		m_namespaces;
@@ -688,28 +1019,46 @@ private:
 	//------ 4. ļļ ------//
 
 	// ļļϣ[ļ] -> [includeļ]
-	std::map<std::string, FileSet>				m_includes;
+	ArenaMap<std::string, FileSet>				m_includes;
+
+	// ģʽα˺ͷļϵͳͷļ
+	FileNameSet									m_skippedBodyHeaders;
+
+	// ģʽļֵָ[ļ] -> [ȺУÿָһַ]
+	std::map<std::string, std::string>			m_condsByName;
+
+	// #includem_includesڼļ
+	std::vector<SkippedInclude>					m_skippedIncludes;
 
 	// ļID
 	FileSet										m_files;
 
 	// ļϵ[ļID] -> [ļID]
-	std::map<FileID, FileID>					m_parents;
+	ArenaMap<FileID, FileID>					m_parents;
+
+	// ļڰеĴ[ļID] -> [ȼ]
+	llvm::DenseMap<FileID, IncludeOrder>		m_includeOrders;
 
 	// ͬһļӦĲͬļID[ļ] -> [ͬļIDб]
-	std::map<std::string, FileSet>				m_sameFiles;
+	ArenaMap<std::string, FileSet>				m_sameFiles;
 
 	// ļIDӦļ[ļID] -> [ļ]
-	std::map<FileID, std::string>				m_fileNames;
+	ArenaMap<FileID, std::string>				m_fileNames;
 
 	// ļIDӦļ[ļID] -> [Сдļ]
-	std::map<FileID, std::string>				m_lowerFileNames;
+	ArenaMap<FileID, std::string>				m_lowerFileNames;
+
+	// ļ״αʱļIDͬһļٴγʱֱõļ[ļ] -> [׸ļID]
+	llvm::DenseMap<const FileEntry*, FileID>	m_fileEntries;
 
 	// ļӦļID[ļ] -> [ļID]
 	std::map<std::string, FileID>				m_fileNameToFileIDs;	
 
 	// ͷļ·б
 	std::vector<HeaderSearchDir>				m_headerSearchPaths;
+
+	// ͷļ·ǰ׺0Ϊڵ
+	std::vector<HeaderSearchNode>				m_headerSearchTrie;
 	
 	// ļid
 	FileID										m_root;
@@ -730,4 +1079,10 @@ private:
 
 	// ǰӡ־ӡ
 	mutable int									m_printIdx;
+
+	// ѯļ
+	mutable LocCache							m_fileLocCache;
+
+	// ѯĺ
+	mutable LocCache							m_macroLocCache;
 };
\ No newline at end of file
@@ -12,10 +12,24 @@
 
 Project Project::instance;
 
+// ȡ﷨Ե
+const char* Project::GetTraversePolicyName() const
+{
+	switch (m_traversePolicy)
+	{
+	case TraversePolicy_Written:		return "written";
+	case TraversePolicy_Instantiation:	return "instantiation";
+	case TraversePolicy_Implicit:		return "implicit";
+	case TraversePolicy_Full:			return "full";
+	}
+
+	return "unknown";
+}
+
 // ӡļб
 void Project::Print() const
 {
-	if (Project::instance.m_logLvl < LogLvl_Max)
+	if (!IsLogLvl<LogLvl_Max>())
 	{
 		return;
 	}
@@ -62,15 +76,270 @@ std::string Project::AddPrintIdx() const
 // ļǷ
 bool Project::CanClean(const char* filename)
 {
-	return Has(instance.m_canCleanFiles, tolower(filename));
+	return instance.m_canCleanTrie.Has(filename);
+}
+
+// ļļɲѯõǰ׺
+void Project::GenerateCanCleanTrie()
+{
+	m_canCleanTrie.Clear();
+
+	for (const std::string &file : m_canCleanFiles)
+	{
+		m_canCleanTrie.AddFile(file);
+	}
+
+	for (const std::string &dir : m_canCleanDirs)
+	{
+		m_canCleanTrie.AddDir(dir);
+	}
+}
+
+// 
+void PathTrie::Clear()
+{
+	m_nodes.assign(1, Node());
+}
+
+// ļ·ļУ
+void PathTrie::AddFile(const std::string &path)
+{
+	Add(path, false);
+}
+
+// ļ·ļµȫļУ·Ӧ/β
+void PathTrie::AddDir(const std::string &dir)
+{
+	Add(dir, true);
+}
+
+// ·
+void PathTrie::Add(const std::string &path, bool isDir)
+{
+	const std::string lowerPath = strtool::tolower(path.c_str());
+
+	int node = 0;
+	size_t pos = 0;
+
+	while (pos < lowerPath.size())
+	{
+		// ҵַͬӽڵ
+		int kid = -1;
+		for (int k : m_nodes[node].kids)
+		{
+			if (m_nodes[k].label[0] == lowerPath[pos])
+			{
+				kid = k;
+				break;
+			}
+		}
+
+		// û½ӽڵ㣬ʣ·Ϊǩ
+		if (kid < 0)
+		{
+			kid = (int)m_nodes.size();
+			m_nodes.push_back(Node());
+			m_nodes[kid].label = lowerPath.substr(pos);
+			m_nodes[node].kids.push_back(kid);
+
+			node = kid;
+			break;
+		}
+
+		// 㹫ǰ׺
+		const std::string &label = m_nodes[kid].label;
+
+		size_t common = 0;
+		while (common < label.size() && pos + common < lowerPath.size() && label[common] == lowerPath[pos + common])
+		{
+			++common;
+		}
+
+		// ƥʱӽڵӹǰ׺
+		if (common < label.size())
+		{
+			int mid = (int)m_nodes.size();
+			m_nodes.push_back(Node());
+
+			m_nodes[mid].label = m_nodes[kid].label.substr(0, common);
+			m_nodes[mid].kids.push_back(kid);
+			m_nodes[kid].label.erase(0, common);
+
+			for (int &k : m_nodes[node].kids)
+			{
+				if (k == kid)
+				{
+					k = mid;
+					break;
+				}
+			}
+
+			kid = mid;
+		}
+
+		node = kid;
+		pos += common;
+	}
+
+	if (isDir)
+	{
+		m_nodes[node].isDir = true;
+	}
+	else
+	{
+		m_nodes[node].isFile = true;
+	}
+}
+
+// ·Ƿ
+bool PathTrie::Has(const char *path) const
+{
+	int node = 0;
+	const char *p = path;
+
+	while (true)
+	{
+		const Node &now = m_nodes[node];
+		if (now.isDir)
+		{
+			return true;
+		}
+
+		if (*p == 0)
+		{
+			return now.isFile;
+		}
+
+		char c = (char)::tolower((unsigned char)*p);
+
+		int kid = -1;
+		for (int k : now.kids)
+		{
+			if (m_nodes[k].label[0] == c)
+			{
+				kid = k;
+				break;
+			}
+		}
+
+		if (kid < 0)
+		{
+			return false;
+		}
+
+		// αǩȫƥ
+		const std::string &label = m_nodes[kid].label;
+		for (size_t i = 0; i < label.size(); ++i, ++p)
+		{
+			if (*p == 0 || (char)::tolower((unsigned char)*p) != label[i])
+			{
+				return false;
+			}
+		}
+
+		node = kid;
+	}
 }
 
 // ǷӦԸļ
 bool Project::IsSkip(const char* filename)
 {
-	for (const std::string &skip : instance.m_skips)
+	return instance.m_skipMatcher.Match(filename);
+}
+
+// ݺļбƥ
+void Project::GenerateSkipMatcher()
+{
+	m_skipMatcher.Build(m_skips);
+}
+
+// ģʽбԶģʽͳһתΪСд
+void MultiPatternMatcher::Build(const FileNameSet &patterns)
+{
+	m_nodes.assign(1, Node());
+
+	// 1. ȫģʽֵ
+	for (const std::string &pattern : patterns)
 	{
-		if (strtool::contain(skip.c_str(), filename))
+		if (pattern.empty())
+		{
+			continue;
+		}
+
+		const std::string lowerPattern = strtool::tolower(pattern.c_str());
+
+		int node = 0;
+		for (char c : lowerPattern)
+		{
+			int next = GetNext(node, c);
+			if (next < 0)
+			{
+				next = (int)m_nodes.size();
+				m_nodes[node].next.push_back(std::make_pair(c, next));
+				m_nodes.push_back(Node());
+			}
+
+			node = next;
+		}
+
+		m_nodes[node].isEnd = true;
+	}
+
+	// 2. αɸڵʧת
+	std::vector<int> todo;
+	todo.push_back(0);
+
+	for (size_t i = 0; i < todo.size(); ++i)
+	{
+		int node = todo[i];
+
+		for (const std::pair<char, int> &edge : m_nodes[node].next)
+		{
+			char c		= edge.first;
+			int kid		= edge.second;
+			int fail	= 0;
+
+			if (node != 0)
+			{
+				int back = m_nodes[node].fail;
+				while (back != 0 && GetNext(back, c) < 0)
+				{
+					back = m_nodes[back].fail;
+				}
+
+				int next = GetNext(back, c);
+				fail = (next >= 0 ? next : 0);
+			}
+
+			m_nodes[kid].fail	= fail;
+			m_nodes[kid].isEnd	= m_nodes[kid].isEnd || m_nodes[fail].isEnd;
+
+			todo.push_back(kid);
+		}
+	}
+}
+
+// ıǷһģʽıӦΪСд
+bool MultiPatternMatcher::Match(const char *text) const
+{
+	if (m_nodes.size() <= 1)
+	{
+		return false;
+	}
+
+	int node = 0;
+
+	for (const char *c = text; *c; ++c)
+	{
+		int next = GetNext(node, *c);
+		while (next < 0 && node != 0)
+		{
+			node = m_nodes[node].fail;
+			next = GetNext(node, *c);
+		}
+
+		node = (next >= 0 ? next : 0);
+		if (m_nodes[node].isEnd)
 		{
 			return true;
 		}
@@ -79,6 +348,20 @@ bool Project::IsSkip(const char* filename)
 	return false;
 }
 
+// ӽڵ㣬أ-1ʾ
+int MultiPatternMatcher::GetNext(int node, char c) const
+{
+	for (const std::pair<char, int> &edge : m_nodes[node].next)
+	{
+		if (edge.first == c)
+		{
+			return edge.second;
+		}
+	}
+
+	return -1;
+}
+
 // Ƴc++׺Դļ
 void Project::Fix()
 {
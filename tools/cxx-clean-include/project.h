@@ -20,15 +20,118 @@ enum LogLvl
 	LogLvl_Max			// ڵԣӡ쳣ӡ﷨
 };
 
+// ־ĬϲơʱɵͣCMakeLists.txtеCXXCLEAN_DEBUG_LOGѡ
+// ͺ󣬸ڸü־ڴӡĵԴ뽫ڱڱ޳
+#ifndef CXXCLEAN_MAX_LOG_LVL
+	#define CXXCLEAN_MAX_LOG_LVL LogLvl_Max
+#endif
+
+// ﷨
+enum TraversePolicy
+{
+	TraversePolicy_Written			= 0,		// ĬϣԴдĴ루죩
+	TraversePolicy_Instantiation	= 1 << 0,	// ģʵĴ
+	TraversePolicy_Implicit			= 1 << 1,	// ʽɵĴ룬磺ʽĹ캯
+	TraversePolicy_Full				= TraversePolicy_Instantiation | TraversePolicy_Implicit
+};
+
 typedef std::set<std::string> FileNameSet;
 typedef std::vector<std::string> FileNameVec;
 
+// ģʽƥAho-CorasickԶģʽжٸֻıɨһ鼴жǷһ
+class MultiPatternMatcher
+{
+public:
+	MultiPatternMatcher()
+		: m_nodes(1)
+	{
+	}
+
+public:
+	// ģʽбԶģʽͳһתΪСд
+	void Build(const FileNameSet &patterns);
+
+	// ıǷһģʽıӦΪСд
+	bool Match(const char *text) const;
+
+private:
+	// Զڵ
+	struct Node
+	{
+		Node()
+			: fail(0)
+			, isEnd(false)
+		{
+		}
+
+		std::vector<std::pair<char, int>>	next;	// ӽڵ㣺[ַ] -> [ڵ]
+		int									fail;	// ʧʱתĽڵ
+		bool								isEnd;	// Ƿģʽڴ˽ʧɴģʽ
+	};
+
+	// ӽڵ㣬أ-1ʾ
+	int GetNext(int node, char c) const;
+
+private:
+	// ȫڵ㣬0Ϊڵ
+	std::vector<Node>			m_nodes;
+};
+
+// ·ǰ׺ѹֵʱͳһתΪСдѯʱַԴСдȽϣڴ
+class PathTrie
+{
+public:
+	PathTrie()
+		: m_nodes(1)
+	{
+	}
+
+public:
+	// 
+	void Clear();
+
+	// ļ·ļУ
+	void AddFile(const std::string &path);
+
+	// ļ·ļµȫļУ·Ӧ/β
+	void AddDir(const std::string &dir);
+
+	// ·Ƿ
+	bool Has(const char *path) const;
+
+private:
+	// ·
+	void Add(const std::string &path, bool isDir);
+
+private:
+	// ڵ
+	struct Node
+	{
+		Node()
+			: isFile(false)
+			, isDir(false)
+		{
+		}
+
+		std::string				label;	// Ӹڵ㵽ڵ·ƬΣСд
+		std::vector<int>		kids;	// ӽڵ
+		bool					isFile;	// Ƿļ·ڴ˽
+		bool					isDir;	// Ƿļ·ڴ˽ԴΪǰ׺·У
+	};
+
+	// ȫڵ㣬0Ϊڵ
+	std::vector<Node>			m_nodes;
+};
+
 // Ŀ
 class Project
 {
 public:
 	Project()
 		: m_isOverWrite(false)
+		, m_isStreaming(false)
+		, m_isSkipFunctionBodies(false)
+		, m_traversePolicy(TraversePolicy_Written)
 		, m_logLvl(LogLvl_0)
 		, m_printIdx(0)
 	{
@@ -50,12 +153,21 @@ public:
 	// Ƴc++׺Դļ
 	void Fix();
 
+	// ļļɲѯõǰ׺
+	void GenerateCanCleanTrie();
+
+	// ݺļбƥ
+	void GenerateSkipMatcher();
+
 	// ӡ + 1
 	std::string AddPrintIdx() const;
 
 	// ӡļб
 	void Print() const;
 
+	// ȡ﷨Ե
+	const char* GetTraversePolicyName() const;
+
 public:
 	static Project instance;
 
@@ -63,21 +175,46 @@ public:
 	// ļбֻڱбڵc++ļĶ
 	FileNameSet					m_canCleanFiles;
 
+	// ļбļµȫļĶ·/β
+	FileNameSet					m_canCleanDirs;
+
+	// m_canCleanFilesm_canCleanDirsɵǰ׺
+	PathTrie					m_canCleanTrie;
+
 	// c++Դļбֻc++׺ļcppcxx
 	FileNameVec					m_cpps;
 
 	// ļб
 	FileNameSet					m_skips;
 
+	// ļбӦƥ
+	MultiPatternMatcher			m_skipMatcher;
+
 	// Ŀ¼
 	std::string					m_workingDir;
 
 	// ѡǷ񸲸ԭc++ļѡرʱĿڵc++ļκθĶ
 	bool						m_isOverWrite;
 
+	// ѡǷ߽߱﷨ʽ뵥Ԫ
+	bool						m_isStreaming;
+
+	// ѡǷӰͷļеĺ壨ϵͳͷļ֮ǰı뵥Ԫ֤ʵֻļⲿͷļ
+	bool						m_isSkipFunctionBodies;
+
+	// ѡ﷨
+	TraversePolicy				m_traversePolicy;
+
 	// ѡӡϸ̶ȣ0 ~ 90ʾӡĬΪ1ϸ9
 	LogLvl						m_logLvl;
 
 	// ǰӡ־ӡ
 	mutable int					m_printIdx;
-};
\ No newline at end of file
+};
+
+// ǰǷҪӡָ־־Ϊģڱ߼ΪfalseôĴ뽫޳
+template <LogLvl lvl>
+inline bool IsLogLvl()
+{
+	return lvl <= CXXCLEAN_MAX_LOG_LVL && Project::instance.m_logLvl >= lvl;
+}
\ No newline at end of file
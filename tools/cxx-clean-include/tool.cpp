@@ -8,6 +8,10 @@
 #include <sys/stat.h>
 #include <io.h>
 #include <fstream>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
 #include <stdarg.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Path.h>
@@ -352,8 +356,97 @@ namespace pathtool
         return f.str();
 	}
 
-	// ·
-	std::string simplify_path(const char* path)
+	// ·棺ͬһ·淶˽ÿֻһΣפֱַ̰̽߳ȫ
+	class PathCache
+	{
+	public:
+		PathCache()
+			: m_isCwdValid(false)
+		{}
+
+		typedef std::unordered_map<std::string, const std::string*> PathMap;
+
+		// ѯ棬δʱcompute㲢뻺棨ڼ䲻computeڲٴβѯ棩
+		template <typename Compute>
+		const std::string& Get(PathMap &cache, const std::string &key, const Compute &compute)
+		{
+			{
+				std::lock_guard<std::mutex> guard(m_lock);
+
+				auto itr = cache.find(key);
+				if (itr != cache.end())
+				{
+					return *itr->second;
+				}
+			}
+
+			std::string value = compute();
+
+			std::lock_guard<std::mutex> guard(m_lock);
+
+			// ͬĽڳֻһݣҵַ
+			const std::string &interned = *m_pool.insert(std::move(value)).first;
+			return *cache.emplace(key, &interned).first->second;
+		}
+
+		// ɾ·ļ·Ľڵǰ·ϵǰ·ǰ·ֻڸı»ȡ
+		std::string GetAbsolutePathKey(const char *path)
+		{
+			if (llvm::sys::path::is_absolute(path))
+			{
+				return path;
+			}
+
+			std::lock_guard<std::mutex> guard(m_lock);
+
+			if (!m_isCwdValid)
+			{
+				llvm::SmallString<512> cwd;
+				llvm::sys::fs::current_path(cwd);
+
+				m_cwd			= cwd.str().str();
+				m_isCwdValid	= true;
+			}
+
+			return m_cwd + '|' + path;
+		}
+
+		// ǰ·Ѹı
+		void OnCurrentPathChanged()
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			m_isCwdValid = false;
+		}
+
+		static PathCache instance;
+
+	public:
+		// [ԭʼ·] -> [򻯺·]
+		PathMap				m_simplifyPaths;
+
+		// [ǰ· + ԭʼ·] -> [򻯺ľ·]
+		PathMap				m_absolutePaths;
+
+		// [ǰ· + ԭʼ·] -> [Сдļ򻯺ľ·]
+		PathMap				m_lowerAbsolutePaths;
+
+	private:
+		// ַأϸĽָ
+		std::unordered_set<std::string>	m_pool;
+
+		// ĵǰ·
+		std::string			m_cwd;
+
+		// ĵǰ·ǷЧ
+		bool				m_isCwdValid;
+
+		std::mutex			m_lock;
+	};
+
+	PathCache PathCache::instance;
+
+	// ·棩
+	static std::string simplify_path_uncached(const char* path)
 	{
 		string native_path = to_linux_path(path);
 		if (native_path.empty())
@@ -436,6 +529,19 @@ namespace pathtool
 		return out;
 	}
 
+	// ·
+	const std::string& simplify_path(const char* path)
+	{
+		static const std::string empty;
+		if (nullptr == path)
+		{
+			return empty;
+		}
+
+		PathCache &cache = PathCache::instance;
+		return cache.Get(cache.m_simplifyPaths, path, [&]() { return simplify_path_uncached(path); });
+	}
+
 	std::string append_path(const char* a, const char* b)
 	{
 		llvm::SmallString<512> path(a);
@@ -444,34 +550,34 @@ namespace pathtool
 		return path.c_str();
 	}
 
-	string get_absolute_path(const char *path)
+	const string& get_absolute_path(const char *path)
 	{
-		if (nullptr == path)
+		static const std::string empty;
+		if (nullptr == path || path[0] == 0x0)
 		{
-			return "";
+			return empty;
 		}
 
-		if (path[0] == 0x0)
+		PathCache &cache = PathCache::instance;
+		return cache.Get(cache.m_absolutePaths, cache.GetAbsolutePathKey(path), [&]() -> std::string
 		{
-			return "";
-		}
-
-		llvm::SmallString<2048> filepath(path);
-		std::error_code error = llvm::sys::fs::make_absolute(filepath);
-		if (error)
-		{
-			return "";
-		}
+			llvm::SmallString<2048> filepath(path);
+			std::error_code error = llvm::sys::fs::make_absolute(filepath);
+			if (error)
+			{
+				return "";
+			}
 
-		string simplifyFilepath = simplify_path(filepath.c_str());
-        return simplifyFilepath;
+			return simplify_path(filepath.c_str());
+		});
 	}
 
-	string get_absolute_path(const char *base_path, const char* relative_path)
+	const string& get_absolute_path(const char *base_path, const char* relative_path)
 	{
+		static const std::string empty;
 		if (nullptr == base_path || nullptr == relative_path)
 		{
-			return "";
+			return empty;
 		}
 
 		if (llvm::sys::path::is_absolute(relative_path))
@@ -483,25 +589,50 @@ namespace pathtool
 			std::string path = append_path(base_path, relative_path);
 			return get_absolute_path(path.c_str());
 		}
-
-		return "";
 	}
 
 	// ȡСдļ·
-	string get_lower_absolute_path(const char *path)
+	const string& get_lower_absolute_path(const char *path)
 	{
-		return tolower(get_absolute_path(path));
+		static const std::string empty;
+		if (nullptr == path || path[0] == 0x0)
+		{
+			return empty;
+		}
+
+		PathCache &cache = PathCache::instance;
+		return cache.Get(cache.m_lowerAbsolutePaths, cache.GetAbsolutePathKey(path), [&]() { return tolower(get_absolute_path(path)); });
+	}
+
+	const string& get_lower_absolute_path(const char *base_path, const char* relative_path)
+	{
+		static const std::string empty;
+		if (nullptr == base_path || nullptr == relative_path)
+		{
+			return empty;
+		}
+
+		if (llvm::sys::path::is_absolute(relative_path))
+		{
+			return get_lower_absolute_path(relative_path);
+		}
+
+		std::string path = append_path(base_path, relative_path);
+		return get_lower_absolute_path(path.c_str());
 	}
 
-	string get_lower_absolute_path(const char *base_path, const char* relative_path)
+	// ǰ·ѱı䣨clangڷÿc++ļǰлĿ¼·Ļµĵǰ·
+	void on_current_path_changed()
 	{
-		return tolower(get_absolute_path(base_path, relative_path));
+		PathCache::instance.OnCurrentPathChanged();
 	}
 
 	// ı䵱ǰļ
 	bool cd(const char *path)
 	{
-		return 0 == _chdir(path);
+		bool ok = (0 == _chdir(path));
+		on_current_path_changed();
+		return ok;
 	}
 
 	// ָ·Ƿ
@@ -674,6 +805,12 @@ namespace timetool
 
 		return buf;
 	}
+
+	// ȡǰʱ̣λ룬ڼʱ
+	double get_seconds()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
 }
 
 namespace logtool
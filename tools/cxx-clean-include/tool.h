@@ -19,10 +19,10 @@ using namespace std;
 
 #define LogInfo(text)	llvm::errs() << "==>[Info][" << __FUNCTION__ << "][" << __LINE__<< "] " << text << "\n"
 #define LogError(text)	llvm::errs() << "==>[Error][" << __FUNCTION__ << "][" << __LINE__<< "] " << text << "\n"
-#define LogInfoByLvl(logLvl, text)	if (Project::instance.m_logLvl >= logLvl) { LogInfo(text); }
-#define LogErrorByLvl(logLvl, text)	if (Project::instance.m_logLvl >= logLvl) { LogError(text); }
+#define LogInfoByLvl(logLvl, text)	if (IsLogLvl<logLvl>()) { LogInfo(text); }
+#define LogErrorByLvl(logLvl, text)	if (IsLogLvl<logLvl>()) { LogError(text); }
 #define Log(text)		llvm::errs() << text << "\n"
-#define GetNameForLog(name, text) if (Project::instance.m_logLvl >= LogLvl_2) { std::stringstream ss; ss << text << "[" << __FUNCTION__ << "][line=" << __LINE__<< "]"; name = ss.str(); }
+#define GetNameForLog(name, text) if (IsLogLvl<LogLvl_2>()) { std::stringstream ss; ss << text << "[" << __FUNCTION__ << "][line=" << __LINE__<< "]"; name = ss.str(); }
 
 namespace strtool
 {
@@ -183,7 +183,7 @@ namespace pathtool
 
 	// ·
 	// 磺d:/a/b/c/../../d/ -> d:/d/
-	std::string simplify_path(const char* path);
+	const std::string& simplify_path(const char* path);
 
 	std::string append_path(const char* a, const char* b);
 
@@ -200,17 +200,20 @@ namespace pathtool
 	// 磺赱ǰ·Ϊd:/a/b/c/
 	//		get_absolute_path("../../d/e/hello2.cpp") = "d:/a/b/d/e/hello2.cpp"
 	//		get_absolute_path("d:/a/b/c/../../d/") = "d:/a/d/"
-	string get_absolute_path(const char *path);
+	const string& get_absolute_path(const char *path);
 
 	// ؼ򻯺ľ· = 򻯣· + ·
 	// 磺get_absolute_path("d:/a/b/c/", "../../d/") = "d:/a/d/"
-	string get_absolute_path(const char *base_path, const char* relative_path);
+	const string& get_absolute_path(const char *base_path, const char* relative_path);
 
 	// ȡСдļ·
-	string get_lower_absolute_path(const char *path);
+	const string& get_lower_absolute_path(const char *path);
 
 	// ȡСдļ·
-	string get_lower_absolute_path(const char *base_path, const char* relative_path);
+	const string& get_lower_absolute_path(const char *base_path, const char* relative_path);
+
+	// ǰ·ѱı䣬֪ͨ·
+	void on_current_path_changed();
 
 	// صǰ·
 	std::string get_current_path();
@@ -285,6 +288,9 @@ namespace htmltool
 namespace timetool
 {
 	std::string get_now(const char* format = "%04d/%02d/%02d-%02d:%02d:%02d");
+
+	// ȡǰʱ̣λ룬ڼʱ
+	double get_seconds();
 }
 
 namespace logtool